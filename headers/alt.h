@@ -0,0 +1,82 @@
+#ifndef ALT_H
+#define ALT_H
+
+#include "csr.h"
+#include <vector>
+#include <climits>
+
+#define N_LANDMARKS 16
+
+/**
+	@brief Landmarks and their distance tables, used by the ALT (A*, Landmarks, Triangle inequality) heuristic
+	@detail Distances are computed once, ignoring cut and full roads. Blocking roads can only make distances longer,
+	so the bounds stay valid for the whole simulation without being recomputed.
+	@var landmarks Vertexes chosen as landmarks
+	@var from Distance from each landmark to each vertex, from[v*L + l] (INT_MAX if unreachable)
+	@var to Distance from each vertex to each landmark, to[v*L + l] (INT_MAX if unreachable)
+	@var stride Number of landmarks the tables have room for (L)
+*/
+class Landmarks {
+	std::vector<unsigned int> landmarks;
+	unsigned int stride = 0;
+	std::vector<int> from;
+	std::vector<int> to;
+
+public:
+	/**
+	 * @brief Landmark selection strategies
+	 * @var FARTHEST Each landmark is the vertex farthest from the ones already chosen
+	 * @var AVOID Each landmark is a leaf of the subtree worst covered by the ones already chosen (Goldberg & Werneck)
+	 */
+	enum Strategy { FARTHEST, AVOID };
+
+	/**
+	 * @brief Chooses the landmarks and computes their distance tables
+	 * @param[in] graph Graph to preprocess (must have its incoming edges built)
+	 * @param[in] count Number of landmarks to choose
+	 * @param[in] strategy Selection strategy
+	 * @detail Time Complexity O(L*(V+E)*log(V)), Space Complexity O(L*V)
+	 */
+	void build(const CSRGraph &graph, unsigned int count = N_LANDMARKS, Strategy strategy = AVOID);
+
+	inline bool isBuilt() const { return !this->landmarks.empty(); }
+	inline unsigned int getNumLandmarks() const { return this->landmarks.size(); }
+	inline const std::vector<unsigned int> &getLandmarks() const { return this->landmarks; }
+
+	/**
+	 * @brief Lower bound of the distance between two vertexes
+	 * @return The bound, or INT_MAX if the tables prove there is no path
+	 * @detail Time Complexity O(L), Space Complexity O(1)
+	 */
+	int lowerBound(unsigned int sourc, unsigned int dest) const;
+
+	/**
+	 * @brief ALT heuristic towards a fixed destination, to be used by astarSearch
+	 */
+	class Heuristic {
+		const Landmarks &tables;
+		unsigned int dest;
+	public:
+		Heuristic(const Landmarks &tables, unsigned int dest) : tables(tables), dest(dest) {}
+		inline int operator()(unsigned int v) const { return this->tables.lowerBound(v, this->dest); }
+	};
+
+private:
+
+	/**
+	 * @brief Computes the distance tables of one landmark
+	 * @param[in] graph Graph to preprocess
+	 * @param[in] pos Position of the landmark in landmarks
+	 */
+	void computeTables(const CSRGraph &graph, unsigned int pos);
+
+	/**
+	 * @brief Chooses the next landmark with the avoid strategy
+	 * @param[in] graph Graph to preprocess
+	 * @param[in] root Root of the shortest path tree to inspect
+	 * @return The chosen vertex
+	 */
+	unsigned int avoidLandmark(const CSRGraph &graph, unsigned int root) const;
+};
+
+#endif /* ALT_H */
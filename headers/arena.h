@@ -0,0 +1,102 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+/**
+	@brief Allocates objects of one type contiguously in big blocks, and frees them all at once
+	@detail Objects are never freed one by one: clear (or the destructor) destroys every object and releases the
+	blocks, so building a graph costs a handful of allocations and the objects made together stay close in memory
+	@var blocks Start of each block, its capacity and the number of objects constructed in it (always a prefix)
+	@var block_size Capacity of a new block, in objects (a bigger array gets a block of its own size)
+*/
+template<class Obj>
+class Arena {
+	struct Block {
+		Obj *data;
+		size_t capacity;
+		size_t used;
+	};
+	std::vector<Block> blocks;
+	size_t block_size;
+
+public:
+	Arena(size_t block_size = 4096) : block_size(block_size) {}
+	~Arena() { this->clear(); }
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+	/**
+		@brief Constructs an object in the arena
+		@param args Arguments of the constructor of Obj
+		@return The new object, valid until clear
+		@detail Time Complexity O(1) amortized , Space Complexity O(1)
+	*/
+	template<class... Args>
+	Obj *create(Args&&... args) {
+		Block &block = this->reserve(1);
+		Obj *slot = new (block.data + block.used) Obj(std::forward<Args>(args)...);
+		block.used++;
+		return slot;
+	}
+
+	/**
+		@brief Constructs n contiguous default objects in the arena
+		@return The first of them, valid until clear
+		@detail Time Complexity O(n) , Space Complexity O(n)
+	*/
+	Obj *createArray(size_t n) {
+		Block &block = this->reserve(n);
+		Obj *first = block.data + block.used;
+		for (Obj *obj = first; obj != first + n; obj++)
+			new (obj) Obj;
+		block.used += n;
+		return first;
+	}
+
+	/**
+		@brief Destroys every object and frees every block
+		@detail Time Complexity O(n) , Space Complexity O(1)
+	*/
+	void clear() {
+		std::allocator<Obj> allocator;
+		for (Block &block : this->blocks) {
+			for (size_t i = 0; i < block.used; i++)
+				block.data[i].~Obj();
+			allocator.deallocate(block.data, block.capacity);
+		}
+		this->blocks.clear();
+	}
+
+	/**
+		@brief Number of objects in the arena
+	*/
+	size_t size() const {
+		size_t n = 0;
+		for (const Block &block : this->blocks)
+			n += block.used;
+		return n;
+	}
+
+private:
+	/**
+		@brief Finds a block with room for n contiguous objects, starting a new one if the last one is too full
+	*/
+	Block &reserve(size_t n) {
+		if (!this->blocks.empty()) {
+			Block &last = this->blocks.back();
+			if (last.capacity - last.used >= n)
+				return last;
+		}
+		size_t capacity = std::max(n, this->block_size);
+		this->blocks.push_back( Block{ std::allocator<Obj>().allocate(capacity), capacity, 0 } );
+		return this->blocks.back();
+	}
+};
+
+#endif /* ARENA_H */
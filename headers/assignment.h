@@ -0,0 +1,107 @@
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+#include "csr.h"
+#include "search.h"
+#include "indexed_heap.h"
+#include "worker_pool.h"
+#include <vector>
+#include <utility>
+
+#define BPR_ALPHA 0.15
+#define BPR_BETA 4
+
+/**
+	@brief Routes a batch of cars together, spreading them over the roads by how congested they get
+	@detail Traffic assignment towards user equilibrium with the Method of Successive Averages (a Frank-Wolfe variant
+	with fixed step 1/k). Roads cost t0*(1 + BPR_ALPHA*(x/c)^BPR_BETA), where t0 is the length, x the cars on the road
+	and c the cars it can still take. Each iteration loads every car on the shortest paths under the current costs
+	(all-or-nothing) and averages that load into the flows. The all-or-nothing phase runs one shortest path tree per
+	origin, on the workers of a pool, and the per road updates are split over the workers as well.
+	Once the flows converge every car gets an actual path, in order, on the converged costs and without exceeding the
+	capacity of any road.
+	@var capacity Cars each road can still take
+	@var flow Cars on each road in the current solution (fractional while iterating)
+	@var cost Congested cost of each road
+	@var workspaces Per worker shortest path trees and loads
+*/
+class TrafficAssignment {
+public:
+	/**
+	 * @brief Convergence report of an assignment
+	 * @var iterations Number of all-or-nothing iterations run
+	 * @var relative_gap (total cost - shortest paths cost) / total cost of the last iteration, 0 at equilibrium
+	 * @var total_cost Sum of the congested cost of every road times its flow, on the converged flows
+	 * @var trees Number of shortest path trees computed to give each car its path
+	 * @var unreachable Number of cars with no path
+	 */
+	struct Stats {
+		unsigned int iterations = 0;
+		double relative_gap = 0;
+		double total_cost = 0;
+		unsigned int trees = 0;
+		unsigned int unreachable = 0;
+	};
+
+	/**
+	 * @brief Assigns the cars and writes a path for each of them
+	 * @param[in] graph Graph to route on, blocked (cut or full) roads are never used
+	 * @param[in] capacity Cars each road can still take
+	 * @param[in] trips Origin and destination of each car
+	 * @param[in] pool Workers to run on
+	 * @param[out] routes Path of each car (same order as trips), not found if it has none
+	 * @param[in] max_iterations Limit of all-or-nothing iterations
+	 * @param[in] tolerance Relative gap at which the flows are considered converged
+	 * @return The convergence report
+	 * @detail Time Complexity O(K*O*(V+E)*log(V)/W), with K iterations, O origins and W workers, Space Complexity O(W*(V+E))
+	 */
+	Stats assign(const CSRGraph &graph, const std::vector<unsigned int> &capacity,
+			const std::vector< std::pair<unsigned int, unsigned int> > &trips, WorkerPool &pool,
+			std::vector<Route> &routes, unsigned int max_iterations = 50, double tolerance = 1e-3);
+
+private:
+	/**
+	 * @brief Shortest path tree and road loads of one worker
+	 * @var dist Cost from the origin to each vertex
+	 * @var parent Vertex preceding each vertex in the tree
+	 * @var parent_edge Road used to reach each vertex in the tree
+	 * @var order Vertexes in the order they were settled
+	 * @var touched Vertexes reached by the tree, the only ones the next tree has to clear
+	 * @var demand Cars going to (or through) each vertex, while loading the tree
+	 * @var load Cars put on each road by the all-or-nothing phase
+	 * @var open_list Open list of the tree
+	 */
+	struct Workspace {
+		std::vector<double> dist;
+		std::vector<unsigned int> parent;
+		std::vector<unsigned int> parent_edge;
+		std::vector<unsigned int> order;
+		std::vector<unsigned int> touched;
+		std::vector<double> demand;
+		std::vector<double> load;
+		IndexedHeap<double> open_list;
+	};
+
+	std::vector<unsigned int> capacity;
+	std::vector<double> flow;
+	std::vector<double> cost;
+	std::vector<Workspace> workspaces;
+
+	/**
+	 * @brief Updates the congested cost of the roads [begin, end) from their flows
+	 */
+	void updateCosts(const CSRGraph &graph, unsigned int begin, unsigned int end);
+
+	/**
+	 * @brief Dijkstra over the current costs, stopping when every destination is settled
+	 * @param[in] graph Graph to route on
+	 * @param[in] origin Root of the tree
+	 * @param[in] targets Number of distinct destinations to settle (marked with demand > 0)
+	 * @param[in] full Roads to skip besides the blocked ones (nullptr for none)
+	 * @param[out] ws Where the tree is left
+	 */
+	void shortestPathTree(const CSRGraph &graph, unsigned int origin, unsigned int targets,
+			const std::vector<unsigned int> *full, Workspace &ws) const;
+};
+
+#endif /* ASSIGNMENT_H */
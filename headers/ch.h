@@ -0,0 +1,114 @@
+#ifndef CH_H
+#define CH_H
+
+#include "csr.h"
+#include "search.h"
+#include <vector>
+
+/**
+	@brief Contraction Hierarchy over a CSR graph, used for fast point to point queries
+	@detail Vertexes are contracted by minimum degree without witness searches, so the hierarchy does not depend
+	on the weights. The weights of the arcs are then computed by a customization pass, which can be repeated
+	incrementally for single edges. This is what keeps the queries exact when roads are cut or become full.
+	@var rank Contraction order of each vertex (higher rank means contracted later)
+	@var up_offsets First upward arc of each vertex, the arcs of v are [up_offsets[v], up_offsets[v+1])
+	@var up_source Lower ranked end of each arc
+	@var up_target Higher ranked end of each arc (sorted by id inside each vertex)
+	@var up_weight Length of the arc going up (lower -> higher ranked vertex)
+	@var down_weight Length of the arc going down (higher -> lower ranked vertex)
+	@var up_mid Middle vertex of the shortcut going up, or NO_EDGE if it is an original edge
+	@var down_mid Middle vertex of the shortcut going down, or NO_EDGE if it is an original edge
+	@var up_edge CSR edge (lower -> higher) behind the arc, or NO_EDGE
+	@var down_edge CSR edge (higher -> lower) behind the arc, or NO_EDGE
+	@var down_offsets First downward arc of each vertex, the lower neighbours of v are [down_offsets[v], down_offsets[v+1])
+	@var down_source Lower ranked end of each downward arc (sorted by id inside each vertex)
+	@var down_arc Upward arc that matches each downward arc
+	@var edge_arc Arc that contains each CSR edge, or NO_EDGE for loops
+	@var queued Whether each arc is waiting to be recomputed by edgeChanged
+*/
+class ContractionHierarchy {
+	std::vector<unsigned int> rank;
+	std::vector<unsigned int> up_offsets;
+	std::vector<unsigned int> up_source;
+	std::vector<unsigned int> up_target;
+	std::vector<int> up_weight;
+	std::vector<int> down_weight;
+	std::vector<unsigned int> up_mid;
+	std::vector<unsigned int> down_mid;
+	std::vector<unsigned int> up_edge;
+	std::vector<unsigned int> down_edge;
+	std::vector<unsigned int> down_offsets;
+	std::vector<unsigned int> down_source;
+	std::vector<unsigned int> down_arc;
+	std::vector<unsigned int> edge_arc;
+	std::vector<char> queued;
+
+public:
+	/**
+	 * @brief Contracts the graph and customizes the arcs with the current weights and flags
+	 * @param[in] graph Graph to contract
+	 * @detail Time Complexity O(V*log(V) + S*d), where S is the number of arcs and d the maximum upward degree, Space Complexity O(S)
+	 */
+	void build(const CSRGraph &graph);
+
+	inline bool isBuilt() const { return !this->rank.empty(); }
+	inline unsigned int getNumArcs() const { return this->up_target.size(); }
+
+	/**
+	 * @brief Updates the arcs that depend on the given edge, after it was cut, filled up or restored
+	 * @param[in] graph Graph the hierarchy was built from
+	 * @param[in] edge CSR edge that changed
+	 * @detail Only the arcs whose weight can change are visited, Time Complexity O(A*d*log(A)), where A is the number of arcs affected
+	 */
+	void edgeChanged(const CSRGraph &graph, unsigned int edge);
+
+	/**
+	 * @brief Recomputes the weight of every arc
+	 * @param[in] graph Graph the hierarchy was built from
+	 * @detail Time Complexity O(S*d), Space Complexity O(1)
+	 */
+	void customize(const CSRGraph &graph);
+
+	/**
+	 * @brief Bidirectional upward search for the shortest path between two vertexes
+	 * @param[in] sourc Start vertex
+	 * @param[in] dest End vertex
+	 * @param[in] forward Workspace of the forward search
+	 * @param[in] backward Workspace of the backward search
+	 * @param[out] path CSR edges of the path, from sourc to dest
+	 * @param[out] explored Number of vertexes settled by both searches
+	 * @return Length of the path, or INT_MAX if there is none
+	 */
+	int query(unsigned int sourc, unsigned int dest, SearchWorkspace &forward, SearchWorkspace &backward,
+			std::vector<unsigned int> &path, unsigned long int &explored) const;
+
+private:
+
+	/**
+	 * @brief Finds the arc between two vertexes
+	 * @param[in] low Lower ranked vertex
+	 * @param[in] high Higher ranked vertex
+	 * @return Index of the arc, or NO_EDGE if they are not connected
+	 * @detail Binary search, Time Complexity O(log(d))
+	 */
+	unsigned int findArc(unsigned int low, unsigned int high) const;
+
+	/**
+	 * @brief Computes the weight of an arc from its original edges and its lower triangles
+	 * @param[in] graph Graph the hierarchy was built from
+	 * @param[in] arc Arc to compute
+	 * @return Whether any of the two weights changed
+	 * @detail Time Complexity O(d), where d is the number of lower neighbours of both ends
+	 */
+	bool recomputeArc(const CSRGraph &graph, unsigned int arc);
+
+	/**
+	 * @brief Appends the CSR edges behind an arc to path
+	 * @param[in] arc Arc to unpack
+	 * @param[in] up Direction in which the arc is traversed
+	 * @param[out] path Where the edges are appended
+	 */
+	void unpackArc(unsigned int arc, bool up, std::vector<unsigned int> &path) const;
+};
+
+#endif /* CH_H */
@@ -0,0 +1,136 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include "geometry.h"
+#include <vector>
+#include <algorithm>
+
+/**
+	@brief Immutable compressed-sparse-row snapshot of a Graph
+	@detail Vertexes are numbered by id_mask, the edges leaving v are [offsets[v], offsets[v+1]).
+	Only the flags can change after the snapshot is built (roads being cut or filled up)
+	@var offsets First edge of each vertex (has numVertex+1 entries)
+	@var targets id_mask of the destination of each edge
+	@var weights Length of each edge (in m)
+	@var flags State of each edge (EDGE_CUT, EDGE_FULL)
+	@var pos_x Position of each vertex on the unit sphere (UnitVector::x)
+	@var pos_y Position of each vertex on the unit sphere (UnitVector::y)
+	@var pos_z Position of each vertex on the unit sphere (UnitVector::z)
+	@var rev_offsets First incoming edge of each vertex, the edges entering v are [rev_offsets[v], rev_offsets[v+1])
+	@var rev_sources Origin of each incoming edge
+	@var rev_edges Forward edge matching each incoming edge (its weight and flags are the ones used)
+*/
+class CSRGraph {
+	std::vector<unsigned int> offsets;
+	std::vector<unsigned int> targets;
+	std::vector<unsigned int> weights;
+	std::vector<unsigned char> flags;
+	std::vector<double> pos_x;
+	std::vector<double> pos_y;
+	std::vector<double> pos_z;
+	std::vector<unsigned int> rev_offsets;
+	std::vector<unsigned int> rev_sources;
+	std::vector<unsigned int> rev_edges;
+
+public:
+	enum EdgeFlag : unsigned char { EDGE_CUT = 1, EDGE_FULL = 2 };
+
+	/**
+		@brief Empties the snapshot and reserves room for a new one
+		@param n_vertex Number of vertexes
+		@param n_edges Expected number of edges
+		@detail Time Complexity O(V) , Space Complexity O(V+E)
+	*/
+	void clear(unsigned int n_vertex, unsigned int n_edges) {
+		this->offsets.assign(n_vertex + 1, 0);
+		this->targets.clear(); this->targets.reserve(n_edges);
+		this->weights.clear(); this->weights.reserve(n_edges);
+		this->flags.clear(); this->flags.reserve(n_edges);
+		this->pos_x.assign(n_vertex, 0);
+		this->pos_y.assign(n_vertex, 0);
+		this->pos_z.assign(n_vertex, 0);
+	}
+
+	inline void setPosition(unsigned int v, const UnitVector &p) {
+		this->pos_x[v] = p.x;
+		this->pos_y[v] = p.y;
+		this->pos_z[v] = p.z;
+	}
+
+	/**
+		@brief Appends an edge, sources must be given in non-decreasing order
+		@return Index of the new edge
+		@detail Time Complexity O(1) amortized , Space Complexity O(1)
+	*/
+	unsigned int addEdge(unsigned int sourc, unsigned int dest, unsigned int weight, unsigned char flag) {
+		this->offsets[sourc + 1]++;
+		this->targets.push_back(dest);
+		this->weights.push_back(weight);
+		this->flags.push_back(flag);
+		return this->targets.size() - 1;
+	}
+
+	/**
+		@brief Turns the per vertex edge counts into offsets and builds the incoming edges, must be called after the last addEdge
+		@detail Time Complexity O(V+E) , Space Complexity O(V+E)
+	*/
+	void finish() {
+		for (unsigned int v = 1; v < this->offsets.size(); v++)
+			this->offsets[v] += this->offsets[v - 1];
+		this->buildReverse();
+	}
+
+	/**
+		@brief Builds the incoming edges of every vertex (the transposed graph), sharing weights and flags with the forward edges
+		@detail Counting sort, Time Complexity O(V+E) , Space Complexity O(V+E)
+	*/
+	void buildReverse() {
+		unsigned int n = this->getNumVertex();
+		this->rev_offsets.assign(n + 1, 0);
+		for (unsigned int t : this->targets)
+			this->rev_offsets[t + 1]++;
+		for (unsigned int v = 1; v <= n; v++)
+			this->rev_offsets[v] += this->rev_offsets[v - 1];
+		this->rev_sources.assign(this->targets.size(), 0);
+		this->rev_edges.assign(this->targets.size(), 0);
+		std::vector<unsigned int> fill(this->rev_offsets.begin(), this->rev_offsets.end() - 1);
+		for (unsigned int v = 0; v < n; v++)
+			for (unsigned int e = this->offsets[v]; e < this->offsets[v + 1]; e++) {
+				unsigned int pos = fill[this->targets[e]]++;
+				this->rev_sources[pos] = v;
+				this->rev_edges[pos] = e;
+			}
+	}
+
+	inline unsigned int getNumVertex() const { return this->offsets.empty() ? 0 : this->offsets.size() - 1; }
+	inline unsigned int getNumEdges() const { return this->targets.size(); }
+	inline unsigned int edgesBegin(unsigned int v) const { return this->offsets[v]; }
+	inline unsigned int edgesEnd(unsigned int v) const { return this->offsets[v + 1]; }
+	inline unsigned int getTarget(unsigned int e) const { return this->targets[e]; }
+	/**
+		@brief Origin of an edge
+		@detail Binary search over the offsets, Time Complexity O(log(V))
+	*/
+	inline unsigned int getSource(unsigned int e) const {
+		return std::upper_bound(this->offsets.begin(), this->offsets.end(), e) - this->offsets.begin() - 1;
+	}
+	inline unsigned int getWeight(unsigned int e) const { return this->weights[e]; }
+	inline unsigned int reverseBegin(unsigned int v) const { return this->rev_offsets[v]; }
+	inline unsigned int reverseEnd(unsigned int v) const { return this->rev_offsets[v + 1]; }
+	inline unsigned int getReverseSource(unsigned int r) const { return this->rev_sources[r]; }
+	inline unsigned int getReverseEdge(unsigned int r) const { return this->rev_edges[r]; }
+	inline UnitVector getPosition(unsigned int v) const {
+		UnitVector p;
+		p.x = this->pos_x[v];
+		p.y = this->pos_y[v];
+		p.z = this->pos_z[v];
+		return p;
+	}
+
+	inline bool isBlocked(unsigned int e) const { return this->flags[e] != 0; }
+	inline unsigned char getFlags(unsigned int e) const { return this->flags[e]; }
+	inline void setFlags(unsigned int e, unsigned char flag) { this->flags[e] = flag; }
+	inline void resetFlags() { this->flags.assign(this->flags.size(), 0); }
+};
+
+#endif /* CSR_H */
@@ -0,0 +1,84 @@
+#ifndef DYNAMIC_SSSP_H
+#define DYNAMIC_SSSP_H
+
+#include "csr.h"
+#include "search.h"
+#include "indexed_heap.h"
+#include <vector>
+#include <climits>
+
+/**
+	@brief Shortest path tree from one vertex, kept exact while edges are blocked and unblocked
+	@detail Dynamic single source shortest paths in the style of Ramalingam & Reps. Blocking a tree edge only
+	invalidates the subtree hanging from it, which is reattached from its unaffected in-neighbours with a Dijkstra
+	restricted to the subtree. Unblocking an edge only improves the vertexes it gives a shorter path to.
+	Blocking an edge outside the tree changes nothing.
+	@var sourc Root of the tree, or NO_EDGE if the tree is not built
+	@var dist Distance from the root to each vertex (INT_MAX if unreachable)
+	@var parent Vertex preceding each vertex in the tree (NO_EDGE for the root and unreachable vertexes)
+	@var parent_edge CSR edge used to reach each vertex in the tree
+	@var affected Whether each vertex belongs to the subtree being repaired
+	@var open_list Open list of the repairs
+	@var repaired Number of vertexes settled by repairs since the last call to takeRepaired
+*/
+class DynamicSSSP {
+	unsigned int sourc = NO_EDGE;
+	std::vector<int> dist;
+	std::vector<unsigned int> parent;
+	std::vector<unsigned int> parent_edge;
+	std::vector<char> affected;
+	IndexedHeap<int> open_list;
+	unsigned long int repaired = 0;
+
+public:
+	/**
+	 * @brief Computes the shortest path tree from a vertex, ignoring blocked (cut or full) edges
+	 * @param[in] graph Graph to search (must have its incoming edges built)
+	 * @param[in] sourc Root of the tree
+	 * @detail Time Complexity O((V+E)*log(V)), Space Complexity O(V)
+	 */
+	void build(const CSRGraph &graph, unsigned int sourc);
+
+	inline bool isBuilt() const { return this->sourc != NO_EDGE; }
+	inline unsigned int getSource() const { return this->sourc; }
+	inline int getDist(unsigned int v) const { return this->dist[v]; }
+
+	/**
+	 * @brief Repairs the tree after an edge was blocked or unblocked
+	 * @param[in] graph Graph the tree was built from, with the new flags of the edge
+	 * @param[in] edge CSR edge that changed
+	 * @detail Time Complexity O((A+E_A)*log(A)), where A is the number of vertexes whose distance changed and E_A their edges
+	 */
+	void edgeChanged(const CSRGraph &graph, unsigned int edge);
+
+	/**
+	 * @brief Reads the path from the root to a vertex
+	 * @param[in] dest Vertex to read the path to
+	 * @param[out] path CSR edges of the path, from the root to dest (empty if dest is unreachable)
+	 * @return Length of the path, or INT_MAX if dest is unreachable
+	 * @detail Time Complexity O(N), Space Complexity O(1)
+	 */
+	int readPath(unsigned int dest, std::vector<unsigned int> &path) const;
+
+	/**
+	 * @brief Number of vertexes settled by repairs since the last call
+	 */
+	unsigned long int takeRepaired();
+
+private:
+
+	/**
+	 * @brief Invalidates the subtree hanging from a vertex and reattaches it
+	 * @param[in] graph Graph the tree was built from
+	 * @param[in] root Vertex whose tree edge was blocked
+	 */
+	void repairSubtree(const CSRGraph &graph, unsigned int root);
+
+	/**
+	 * @brief Dijkstra from the vertexes in the open list, settling the ones whose distance improves
+	 * @param[in] graph Graph the tree was built from
+	 */
+	void propagate(const CSRGraph &graph);
+};
+
+#endif /* DYNAMIC_SSSP_H */
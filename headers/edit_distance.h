@@ -0,0 +1,101 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#define EDIT_WORD_BITS 64
+
+/**
+	@brief Pattern of the bit-parallel edit distance (Myers' algorithm, in Hyyro's formulation), read against a text
+	one character at a time, so the text can also be a path of a trie
+	@detail A column of the DP table is kept as the differences between consecutive rows, one bit per row in 64 bit
+	blocks, so reading a character costs O(m/64) word operations instead of O(m). Characters are compared as they are
+	@var length Number of characters of the pattern
+	@var n_blocks Number of 64 bit blocks of a column
+	@var peq Bits of the positions of the pattern equal to each character, block b of character c at c*n_blocks + b
+*/
+class MyersPattern {
+	size_t length;
+	size_t n_blocks;
+	std::vector<uint64_t> peq;
+public:
+
+	/**
+		@brief Column of the DP table, the edit distances between the text read and every prefix of the pattern
+		@var depth Number of characters of the text read, the distance to the empty prefix
+		@var bits Rows where the distance increases (at 2*b for block b) and decreases (at 2*b+1) from the row above
+	*/
+	struct Column {
+		unsigned int depth;
+		std::vector<uint64_t> bits;
+	};
+
+	MyersPattern(const std::string &pattern);
+
+	inline size_t size() const { return this->length; }
+
+	/**
+		@brief Column before reading any character of the text
+	*/
+	Column start() const;
+
+	/**
+		@brief Reads the next character of the text
+		@param[in,out] column Column to advance
+		@param[in] chr Character read
+		@param[in] n_blocks Blocks to advance, the blocks above are left as they are
+		@detail Time Complexity O(m/64), Space Complexity O(1)
+	*/
+	void advance(Column &column, char chr, size_t n_blocks) const;
+	inline void advance(Column &column, char chr) const { this->advance(column, chr, this->n_blocks); }
+
+	/**
+		@brief Edit distance between the text read and the whole pattern
+		@detail Time Complexity O(m/64), Space Complexity O(1)
+	*/
+	unsigned int distance(const Column &column) const;
+
+	/**
+		@brief Smallest edit distance between the text read and a prefix of the pattern, a lower bound of the distance
+		between the pattern and any text starting with the text read
+		@detail Only the rows where the distance decreases are checked, Time Complexity O(m/64 + d), d such rows,
+		Space Complexity O(1)
+	*/
+	unsigned int minimum(const Column &column) const;
+
+	/**
+		@brief Edit distance between the pattern and a text
+		@detail Time Complexity O(n*m/64), n text length and m pattern length, Space Complexity O(m/64)
+	*/
+	unsigned int distance(const std::string &text) const;
+
+	/**
+		@brief Edit distance between the pattern and a text, if it is at most max_dist
+		@return The edit distance, or max_dist + 1 if it is greater
+		@detail Only the blocks holding rows within max_dist of the diagonal are advanced (Ukkonen's cutoff), and the
+		text stops being read once the distance can no longer come down to max_dist.
+		Time Complexity O(n*k/64), n text length and k max_dist, Space Complexity O(m/64)
+	*/
+	unsigned int distance(const std::string &text, unsigned int max_dist) const;
+};
+
+/**
+ * @brief Computates the edit distance between the pattern and the text
+ * @param[in] pattern The pattern to search for
+ * @param[in] text The text to search in
+ * @return The edit distance between the two parameters
+ * @detail Bit-parallel, case sensitive, Time Complexity O(n*m/64), Space Complexity O(256*m/64)
+ */
+unsigned int editDistance(const std::string &pattern, const std::string &text);
+
+/**
+ * @brief Computates the edit distance between the pattern and the text, as long as it is at most max_dist
+ * @return The edit distance, or max_dist + 1 if it is greater
+ * @detail Bit-parallel and banded, case sensitive, Time Complexity O(n*k/64), Space Complexity O(256*m/64)
+ */
+unsigned int boundedEditDistance(const std::string &pattern, const std::string &text, unsigned int max_dist);
+
+#endif /* EDIT_DISTANCE_H */
@@ -0,0 +1,110 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+const double EARTH_RADIUS = 6371; //its in km
+const double EARTH_RADIUS_M = EARTH_RADIUS * 1000;
+
+/**
+	@brief Point on the unit sphere, precomputed once per vertex so distances need no trigonometry on the sines and cosines
+	@var x Towards latitude 0, longitude 0
+	@var y Towards latitude 0, longitude 90 E
+	@var z Towards the north pole
+*/
+struct UnitVector {
+	double x = 0, y = 0, z = 0;
+};
+
+/**
+	@brief Converts a position on earth to its unit vector
+	@param latitude Latitude (in radians)
+	@param longitude Longitude (in radians)
+	@detail Time Complexity O(1) , Space Complexity O(1)
+*/
+inline UnitVector unitVector(double latitude, double longitude) {
+	UnitVector p;
+	p.x = cos(latitude) * cos(longitude);
+	p.y = cos(latitude) * sin(longitude);
+	p.z = sin(latitude);
+	return p;
+}
+
+/**
+	@brief Straight line distance between two points of the unit sphere
+	@detail Time Complexity O(1) , Space Complexity O(1)
+*/
+inline double chordLength(const UnitVector &p, const UnitVector &q) {
+	double dx = p.x - q.x, dy = p.y - q.y, dz = p.z - q.z;
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+	Half chords below this use the series of asin (the error of the terms left out is below 1e-19 m on earth)
+*/
+const double SMALL_HALF_CHORD = 0.01;
+
+/**
+	@brief Length of the arc (in m) behind a chord of the unit sphere, given half of the chord
+	@detail Short arcs, which are all the roads, use asin(h) ~ h + h^3/6 + 3h^5/40 + 5h^7/112, the rest calls asin.
+	The series is never below h, so the arc is never below the chord. batchGreatCircleDistance computes the
+	same operations in the same order, so both give the same lengths.
+	@detail Time Complexity O(1) , Space Complexity O(1)
+*/
+inline double arcLength(double half_chord) {
+	if (half_chord < SMALL_HALF_CHORD) {
+		double h2 = half_chord * half_chord;
+		double series = ((5.0 / 112 * h2 + 3.0 / 40) * h2 + 1.0 / 6) * h2;
+		return 2 * EARTH_RADIUS_M * (half_chord + half_chord * series);
+	}
+	return 2 * EARTH_RADIUS_M * asin(half_chord < 1 ? half_chord : 1);
+}
+
+/**
+	@brief Calculates the distance between two points on earth (in m) along the great circle through them
+	@detail The arc is 2*asin(chord/2), which is the haversine formula without the trigonometry of the positions.
+	Rounded up, so it is never shorter than the straight line given by chordLowerBound.
+	@detail Time Complexity O(1) , Space Complexity O(1)
+*/
+inline int greatCircleDistance(const UnitVector &p, const UnitVector &q) {
+	return ceil(arcLength(chordLength(p, q) / 2));
+}
+
+/**
+	@brief Positions of many points, as one array per coordinate so they can be processed in vector registers
+	@var x UnitVector::x of each point
+	@var y UnitVector::y of each point
+	@var z UnitVector::z of each point
+*/
+struct UnitVectorArray {
+	std::vector<double> x, y, z;
+
+	inline unsigned int size() const { return this->x.size(); }
+	inline void reserve(unsigned int n) { this->x.reserve(n); this->y.reserve(n); this->z.reserve(n); }
+	inline void push_back(const UnitVector &p) { this->x.push_back(p.x); this->y.push_back(p.y); this->z.push_back(p.z); }
+};
+
+/**
+	@brief Computes greatCircleDistance(a[i], b[i]) for every i
+	@param a First point of each pair
+	@param b Second point of each pair (same size as a)
+	@param distances Where the distances are written (resized to the number of pairs)
+	@detail Uses AVX2, four pairs at a time, when the processor has it and falls back to scalar code otherwise.
+	Both give exactly the same lengths.
+	@detail Time Complexity O(N) , Space Complexity O(1)
+*/
+void batchGreatCircleDistance(const UnitVectorArray &a, const UnitVectorArray &b, std::vector<int> &distances);
+
+/**
+	@brief Lower bound of the distance between two points on earth (in m): the straight line through the earth
+	@detail A chord is never longer than its arc, and rounding it down keeps it consistent with road lengths
+	measured by greatCircleDistance, so A* stays exact with it.
+	@detail Time Complexity O(1) , Space Complexity O(1)
+*/
+inline int chordLowerBound(const UnitVector &p, const UnitVector &q) {
+	return EARTH_RADIUS_M * chordLength(p, q);
+}
+
+#endif /* GEOMETRY_H */
@@ -3,6 +3,17 @@
 
 #include "../graph_viewer/graphviewer.h"
 #include "../headers/trie.h"
+#include "../headers/csr.h"
+#include "../headers/search.h"
+#include "../headers/ch.h"
+#include "../headers/alt.h"
+#include "../headers/worker_pool.h"
+#include "../headers/dynamic_sssp.h"
+#include "../headers/assignment.h"
+#include "../headers/reachability.h"
+#include "../headers/scc.h"
+#include "../headers/geometry.h"
+#include "../headers/arena.h"
 #include <vector>
 #include <unordered_map>
 #include <map>
@@ -20,6 +31,21 @@ template<class T> class Vertex;
 template<class T> pair<int, int> calculatePosition(Vertex<T>* v);
 
 const int INT_INFINITY = INT_MAX;
+const unsigned int ID_BLOCK = 4096; //IDs looked up by each task of getVertexesByID
+
+/**
+	@brief Algorithms that can be used to find the path of a car
+	@var ASTAR A* over the whole graph
+	@var CONTRACTION_HIERARCHIES Bidirectional upward search over a Contraction Hierarchy (built on first use)
+	@var ALT A* with the landmark heuristic instead of the haversine one (landmarks chosen on first use)
+	@var BIDIRECTIONAL_ASTAR A* from both ends at once, meeting in the middle
+	@var ONE_TO_MANY One shortest path tree for all the cars
+	@var DYNAMIC_TREE One shortest path tree for all the cars, repaired as roads are cut and filled up instead of searched again
+	@var TRAFFIC_ASSIGNMENT All the cars routed together, spread over the roads by congestion (see TrafficAssignment)
+	@detail ASTAR, CONTRACTION_HIERARCHIES, ALT and BIDIRECTIONAL_ASTAR route the cars in parallel. A car whose path was
+	filled up by the cars committed before it is searched again (with A* for ONE_TO_MANY).
+*/
+enum RoutingAlgorithm { ASTAR, CONTRACTION_HIERARCHIES, ALT, BIDIRECTIONAL_ASTAR, ONE_TO_MANY, DYNAMIC_TREE, TRAFFIC_ASSIGNMENT };
 
 /**
 	@brief Class Vertex
@@ -27,12 +53,10 @@ const int INT_INFINITY = INT_MAX;
 	@var id_mask Id_mask that is used by the program (assigned at the loading stage, starts from 0 and increments)
 	@var latitudeRadians Latitude of the vertex
 	@var longitudeRadians Longitude of the vertex
+	@var position Position of the vertex on the unit sphere, used to measure distances
 	@var adjacent Hash map where key is id_mask of destination Vertex, value is the Edge
-	@var dist Used for the A* algorithm
 	@var resolved Whether the vertex was already solved or not (used for graphviewer purposes) if(resolved) color=ORANGE
-	@var visited Used for the dfs like visit
 	@var reachable Whether the vertex is reachable from the start node or not (start node is the origin node of cut edge)
-	@var process Used for the A* algorithm, if vertex was processed it is in the closed list
  */
 template<class T>
 class Vertex {
@@ -40,17 +64,14 @@ class Vertex {
 	long long int id_mask;
 	double latitudeRadians;
 	double longitudeRadians;
+	UnitVector position;
 	unordered_map<long long int,Edge<T>* > adjacent;
 
-	int dist;
 	bool resolved = false;
-	bool visited = false;
 	bool reachable = true;
-	bool process = false;
 public:
 	Vertex(T in, double latRad, double longRad) :
-		ID(in), latitudeRadians(latRad), longitudeRadians(longRad), dist(0) , path(NULL){};
- 	Vertex(long long int id_mask) : id_mask(id_mask) {};
+		ID(in), latitudeRadians(latRad), longitudeRadians(longRad), position(unitVector(latRad, longRad)) {};
 
 	inline void addEdge(Edge<T> *edge) { this->adjacent.emplace( edge->dest->id_mask , edge ); }
 
@@ -58,8 +79,8 @@ public:
 	inline long long int getIDMask() const {return this->id_mask;}
 	inline double getLatitude() const { return latitudeRadians; }
 	inline double getLongitude() const { return longitudeRadians; }
+	inline const UnitVector &getPosition() const { return position; }
 	inline unordered_map<long long int,Edge<T>*> &getAdjacent() { return adjacent; }
-	inline int getDist() const { return dist; }
 	inline bool getReachable() const {return this->reachable;}
 
 	inline void setReachable(bool r) {this->reachable = r;}
@@ -67,65 +88,75 @@ public:
 	inline void setInfo(T id) { ID = id; }
 	inline void setMaskID(long long int mask) { id_mask = mask; }
 
-	Vertex* path;
-
 	friend class Graph<T> ;
 };
 
+/**
+	@brief Metadata of an Edge that routing never reads, kept out of the Edge so that the Edges stay small
+	@var sourc Vertex from which the Edge leaves
+	@var ID Unique ID of the Edge
+	@var streetName Name of the street
+	@var isTwoWays Whether the road is two ways or not
+	@var graph_ID ID of the Edge in the graphviewer
+	@var is_path Whether the Edge is a path to some destination or not (used for graphviewer purposes)
+*/
+template<class T>
+struct EdgeInfo {
+	Vertex<T> *sourc = nullptr;
+	T ID;
+	string streetName;
+	int graph_ID = 0;
+	bool isTwoWays = true;
+	bool is_path = false;
+
+	EdgeInfo(T id) : ID(id) {}
+};
+
 /**
 	@brief Class Edge (represents a road)
 	@var dest Vertex to which the Edge points
+	@var info Metadata of the Edge (name, origin, graphviewer state), see EdgeInfo
 	@var weight Length of the road (in m)
-	@var ID Unique ID of the Edge
-	@var max_number_cars Maximum number of cars allowed to traverse this road
 	@var curr_number_cars Current number of cars traversing this road
-	@var streetName Name of the street
-	@var isTwoWays Whether the road is two ways or not
+	@var csr_index Index of this Edge in the CSR snapshot of the graph
+	@var max_number_cars Maximum number of cars allowed to traverse this road
 	@var is_cut Whether the road is cut or not (if a road is cut it cannor be traversed)
-	@var name_mask Mask used to easily reference the Edge
-	@var graph_ID ID of this Edge in the graphviewer
-	@var is_path Whether this edge is a path to some destination or not (used for graphviewer purposes)
 */
 template<class T>
 class Edge {
-	Vertex<T> *sourc;
 	Vertex<T> * dest;
+	EdgeInfo<T> *info;
 	unsigned int weight; //its in m
-	T ID;
-	const unsigned int max_number_cars;
 	unsigned int curr_number_cars = 0;
-	string streetName;
-	bool isTwoWays;
+	unsigned int csr_index = NO_EDGE;
+	const unsigned short max_number_cars;
 	bool is_cut;
-
-	int graph_ID;
-	bool is_path  = false;
 public:
-	Edge(Vertex<T> *d, T id, int w) :
-		dest(d), weight(w), ID(id), max_number_cars(rand() % 75 + 25), isTwoWays(true), is_cut(false) { }
-	Edge() : dest(NULL), weight(0) , ID(0) , max_number_cars(0){};
+	Edge(Vertex<T> *d, EdgeInfo<T> *info, int w) :
+		dest(d), info(info), weight(w), max_number_cars(rand() % 75 + 25), is_cut(false) { }
 
 	inline void cutRoad() {is_cut = true;}
 	inline bool isFull() const {return this->curr_number_cars == this->max_number_cars;}
 	inline bool isCut() const {return is_cut;}
-	inline bool isPath() const {return this->is_path;}
-
-	inline void setPath(bool p) {this->is_path = p;}
-	inline void setName(string s) {streetName = s;}
-	inline void setTwoWays(bool b) {isTwoWays = b;}
-	inline void setGraphID(int x) {this->graph_ID = x;}
-	inline void setSourc(Vertex<T> *sourc) {this->sourc = sourc;}
-
-	inline int getGraphID() {return this->graph_ID;}
-	inline T getID() const {return this->ID;}
-	inline string getName() const {return this->streetName;}
-	inline bool getTwoWays() const {return this->isTwoWays;}
+	inline bool isPath() const {return this->info->is_path;}
+
+	inline void setPath(bool p) {this->info->is_path = p;}
+	inline void setName(string s) {this->info->streetName = s;}
+	inline void setTwoWays(bool b) {this->info->isTwoWays = b;}
+	inline void setGraphID(int x) {this->info->graph_ID = x;}
+	inline void setSourc(Vertex<T> *sourc) {this->info->sourc = sourc;}
+
+	inline int getGraphID() {return this->info->graph_ID;}
+	inline unsigned int getCSRIndex() const {return this->csr_index;}
+	inline T getID() const {return this->info->ID;}
+	inline string getName() const {return this->info->streetName;}
+	inline bool getTwoWays() const {return this->info->isTwoWays;}
 	inline unsigned int getMaxCars() const {return this->max_number_cars;}
 	inline unsigned int getWeight() const {return this->weight;}
 	inline Vertex<T>* getDest() {return this->dest;}
-	inline Vertex<T>* getSourc() {return this->sourc;}
+	inline Vertex<T>* getSourc() {return this->info->sourc;}
 
-	inline bool operator<(const Edge<T> e) {return this->ID < e.ID;}
+	inline bool operator<(const Edge<T> e) {return this->getID() < e.getID();}
 
 	friend class Graph<T> ;
 	friend class Vertex<T> ;
@@ -144,40 +175,101 @@ struct hashFuncs{
 /**
 	@brief Graph class, represents a map
 	@var vertexSet All vertexes of the graph
+	@var vertex_arena Storage of the vertexes, freed with the graph
+	@var edge_arena Storage of the edges, freed with the graph
+	@var edge_info_arena Storage of the metadata of the edges (see EdgeInfo), freed with the graph
 	@var cars_destination List which represents the various cars in the closed road
 	@var counter Used to give a unique id_mask to vertexes
+	@var csr Compressed-sparse-row snapshot used by the search algorithms
+	@var vertices Every vertex by id_mask (also the vertex behind each CSR vertex)
+	@var sorted_ids IDs (from the files) of the vertexes, sorted, filled by indexVertexIDs
+	@var sorted_masks id_mask of the vertex of each ID of sorted_ids
+	@var csr_edge Edge behind each CSR edge
+	@var ch Contraction Hierarchy of the graph, empty until buildContractionHierarchy is called
+	@var landmarks Landmarks of the ALT heuristic, empty until buildLandmarks is called
+	@var pool Threads used to route the cars and to parse the input files
+	@var workspaces Search state of each worker of the pool
+	@var backward_workspaces Search state of the backward half of bidirectional searches, for each worker
+	@var tree Shortest path tree of DYNAMIC_TREE, kept up to date by edgeChanged once built
+	@var assignment Engine of TRAFFIC_ASSIGNMENT
+	@var routes Path planned for each car of cars_destination (same order)
+	@var route_dest Destination (id_mask) of each car of cars_destination (same order)
+	@var reach Vertexes reachable from the last cut road, where its cars are generated
+	@var components Strongly connected components of the roads not cut, used to reject unreachable cars before searching
+	@var dirty_edges Edges cut or used by some car since the last resetGraph, the only ones it needs to restore
 */
 template<class T>
 class Graph {
 	unordered_set<Vertex<T> *,hashFuncs,hashFuncs> vertexSet;
+	Arena< Vertex<T> > vertex_arena;
+	Arena< Edge<T> > edge_arena;
+	Arena< EdgeInfo<T> > edge_info_arena;
 	map<string, Edge<T>*> nameToEdge;
 	Trie *trie;
 	list<Vertex<T> *> cars_destination;
 	unsigned long int counter = 0;
+	CSRGraph csr;
+	vector<Vertex<T> *> vertices;
+	vector<T> sorted_ids;
+	vector<unsigned int> sorted_masks;
+	vector<Edge<T> *> csr_edge;
+	ContractionHierarchy ch;
+	Landmarks landmarks;
+	WorkerPool pool;
+	vector<SearchWorkspace> workspaces;
+	vector<SearchWorkspace> backward_workspaces;
+	DynamicSSSP tree;
+	TrafficAssignment assignment;
+	vector<Route> routes;
+	vector<unsigned int> route_dest;
+	Reachability reach;
+	ComponentIndex components;
+	vector<Edge<T> *> dirty_edges;
+
+	void edgeChanged(Edge<T> *edge);
+	void markDirty(Edge<T> *edge);
+	void searchRoute(RoutingAlgorithm algorithm, unsigned int sourc, unsigned int dest, const unsigned long int NODES_LIMIT, Route &route, unsigned int worker);
 
 public:
 	Graph() { this->trie = new Trie; }
+	~Graph() { delete this->trie; }
+	inline Vertex<T> *createVertex(T id, double latRad, double longRad) {return this->vertex_arena.create(id, latRad, longRad);}
+	inline Edge<T> *createEdge(Vertex<T> *dest, T id, int w) {return this->edge_arena.create(dest, this->edge_info_arena.create(id), w);}
 	void addVertex(Vertex<T> *v);
 	bool addEdge(const T &sourc, const T &dest, int w);
 	bool addEdge(Edge<T>* edge, Vertex<T>* from);
 	bool removeEdge(const T &sourc, const T &dest);
-	inline void initializeSet(const unsigned int size) {this->vertexSet = unordered_set<Vertex<T> *,hashFuncs,hashFuncs>(size);}
+	inline void initializeSet(const unsigned int size) {this->vertexSet = unordered_set<Vertex<T> *,hashFuncs,hashFuncs>(size); this->vertices.reserve(size);}
 
 	inline unordered_set<Vertex<T> *,hashFuncs,hashFuncs> &getVertexSet() {return this->vertexSet;}
 	inline int getNumVertex() const {return this->vertexSet.size();}
 	inline unsigned long int getCounter() const {return this->counter;}
 	inline list<Vertex<T> *> &getCarsDest() {return this->cars_destination;}
+	inline const CSRGraph &getCSR() const {return this->csr;}
 	inline void insertWordToTrie(string &word) {this->trie->insertWord(word);}
+	inline void buildTrie() {this->trie->build();}
 	inline bool exactWordSearch(string &word) const {return this->trie->exactWordSearch(word);}
-	inline list<string>* approximateWordSearch(string &word) const { return this->trie->approximateWordSearch(word); }
+	inline vector<fuzzy_match_t> approximateWordSearch(const string &word, unsigned int max_distance, size_t k) const { return this->trie->approximateWordSearch(word, max_distance, k); }
 	inline void insertNameToEdge(const string &word, Edge<T> *ptr) { this->nameToEdge.insert(std::pair< string,Edge<T>* >(word, ptr)); }
-	Vertex<T>* getVertexByIDMask(long long int id) const;
-
-
-	void updatePath( Vertex<T> *v);
-	void resetAlgorithmVars();
+	inline Vertex<T>* getVertexByIDMask(long long int id) const {return (id >= 0 && (unsigned long int) id < this->vertices.size()) ? this->vertices[id] : nullptr;}
+	void indexVertexIDs();
+	Vertex<T>* getVertexByID(const T &id) const;
+	void getVertexesByID(const vector<T> &ids, vector<Vertex<T>*> &found);
+	void buildCSR();
+	void buildContractionHierarchy();
+	inline bool hasContractionHierarchy() const {return this->ch.isBuilt();}
+	void buildLandmarks();
+	inline bool hasLandmarks() const {return this->landmarks.isBuilt();}
+
+	inline unsigned int getNumWorkers() const {return this->pool.size();}
+	inline WorkerPool &getPool() {return this->pool;}
+
+	void updatePath(const Route &route);
 	void generateCarPaths( Vertex<T> *v, unsigned long int &n_nodes);
-	void Astar(Vertex<T> *sourc, Vertex<T> *dest,const unsigned long int NODES_LIMIT);
+	inline const Reachability &getReachability() const {return this->reach;}
+	void findPath(RoutingAlgorithm algorithm, Vertex<T> *sourc, Vertex<T> *dest, const unsigned long int NODES_LIMIT, Route &route);
+	void planRoutes(RoutingAlgorithm algorithm, Vertex<T> *sourc, const unsigned long int NODES_LIMIT);
+	const Route &commitRoute(unsigned int car, RoutingAlgorithm algorithm, Vertex<T> *sourc, const unsigned long int NODES_LIMIT);
 	bool moveCar(Edge<T> &from, long long int &car, Edge<T> &to);
 	Vertex<T> * cutStreet(string &streetName, unsigned long int &n_nodes);
 	void initDestinations();
@@ -186,32 +278,25 @@ public:
 	void resetGraph();
 };
 
-/**
-	@brief Resets the variables needed by the algorithms
-	@detail Time Complexity O(V) , Space Complexity O(1)
-*/
-template<class T>
-void Graph<T>::resetAlgorithmVars(){
-	for (Vertex<T> * v : this->vertexSet){
-		v->visited = false;
-	}
-}
-
 /**
 	@brief Generates paths of cars beyond the desired vertex
 	@param v Vertex to start generation from
-	@detail Time Complexity O(V+E) , Space Complexity O(V)
+	@param n_nodes Set to the number of vertexes reachable from v (v included)
+	@detail Every vertex reachable from v gets a car with probability 1/10, in id_mask order so the cars do not depend
+	on the order the parallel BFS reached them in
+	@detail Time Complexity O( (V+E)/W ), with W workers , Space Complexity O(V)
 */
 template <class T>
 void Graph<T>::generateCarPaths(Vertex<T> *v, unsigned long int &n_nodes) {
-	v->visited = true;
-	if ( (rand() % 10) == 1 ){
-		this->cars_destination.push_back(v);
-	}
-	for (pair<long long int , Edge<T> *> p : v->adjacent){
-	    if ( p.second->dest->visited == false )
-	    	generateCarPaths(p.second->dest , ++n_nodes);
-	}
+	if (this->csr.getNumVertex() != this->counter)
+		this->buildCSR();
+	n_nodes = this->reach.explore(this->csr, v->id_mask, this->pool);
+	const vector<uint64_t> &bitmap = this->reach.getBitmap();
+	for (unsigned int w = 0; w < bitmap.size(); w++)
+		for (uint64_t bits = bitmap[w]; bits != 0; bits &= bits - 1)
+			if ( (rand() % 10) == 1 ){
+				this->cars_destination.push_back( this->vertices[w * 64 + __builtin_ctzll(bits)] );
+			}
 }
 
 /**
@@ -225,10 +310,11 @@ Vertex<T> * Graph<T>::cutStreet(string &streetName, unsigned long int &n_nodes)
 	auto it = this->nameToEdge.find(streetName);
 	if ( it != this->nameToEdge.end() ) { //Edge found
 		cout << "Cutting edge |" << streetName << "|\n";
-		this->resetAlgorithmVars();
 		this->generateCarPaths(it->second->dest, n_nodes);
+		this->markDirty(it->second);
 		it->second->cutRoad();
-		return it->second->sourc;
+		this->edgeChanged(it->second);
+		return it->second->getSourc();
 	}
 
 	return nullptr;
@@ -236,25 +322,36 @@ Vertex<T> * Graph<T>::cutStreet(string &streetName, unsigned long int &n_nodes)
 
 /**
 	@brief Resets the graph to its original state
-	@detail Time Complexity O(V+E) , Space Complexity O(1)
+	@detail Only the car destinations and the dirty edges are restored, Time Complexity O(C+D) ,
+	where C is the number of cars and D the number of dirty edges (plus the arcs of the Contraction Hierarchy depending on them), Space Complexity O(1)
 */
 template<class T>
 void Graph<T>::resetGraph(){
-	this->cars_destination.clear();
-	for (Vertex<T> * vertex : this->vertexSet) {
-		vertex->dist = INT_MAX;
+	for (Vertex<T> * vertex : this->cars_destination) {
 		vertex->resolved = false;
-		vertex->visited = false;
 		vertex->reachable = true;
-		vertex->process = false;
-		vertex->path = nullptr;
-		for(pair<long long int , Edge<T>* > p : vertex->adjacent){
-			Edge<T> * edge = p.second;
-			edge->is_cut = false;
-			edge->is_path = false;
-			edge->curr_number_cars = 0;
-		}
 	}
+	this->cars_destination.clear();
+	this->routes.clear();
+	this->route_dest.clear();
+	for (Edge<T> * edge : this->dirty_edges) {
+		edge->is_cut = false;
+		edge->setPath(false);
+		edge->curr_number_cars = 0;
+		this->edgeChanged(edge);
+	}
+	this->dirty_edges.clear();
+}
+
+/**
+	@brief Records an edge that is about to be cut or used by a car, so that resetGraph restores it
+	@param edge Edge about to change
+	@detail Time Complexity O(1) amortized , Space Complexity O(1)
+*/
+template<class T>
+void Graph<T>::markDirty(Edge<T> *edge) {
+	if (!edge->is_cut && !edge->isPath() && edge->curr_number_cars == 0)
+		this->dirty_edges.push_back(edge);
 }
 
 /**
@@ -320,21 +417,18 @@ void Graph<T>::updateGraphViewer( GraphViewer *gv) const{
 }
 
 /**
-	@brief Updates the number of cars of the path leading to vertex
-	@param v Pointer to destination vertex (member variable path gives the path to that vertex)
+	@brief Updates the number of cars of the edges of a path
+	@param route Path of the car
 	@detail Time Complexity O(N) , Space Complexity O(1)
 */
 template<class T>
-void Graph<T>::updatePath( Vertex<T> *v){
-	Vertex<T> *src = v->path;
-	Vertex<T> *dest = v;
-	while( src != NULL){
-		Edge<T> * edge = src->adjacent[dest->id_mask];
+void Graph<T>::updatePath(const Route &route){
+	for (unsigned int e : route.edges){
+		Edge<T> * edge = this->csr_edge[e];
+		this->markDirty(edge);
 		edge->curr_number_cars++;
 		edge->setPath(true);
-		dest->path = NULL;
-		dest = src;
-		src = src->path;
+		this->edgeChanged(edge);
 	}
 	cout << endl;
 }
@@ -348,98 +442,319 @@ template<class T>
 void Graph<T>::addVertex(Vertex<T> *v) {
 	v->id_mask = this->counter++;
 	this->vertexSet.insert(v);
+	this->vertices.push_back(v);
 }
 
 /**
-	@brief Gets the designated vertex
-	@param id id_mask of the vertex
-	@return Vertex specified
+	@brief Builds the CSR snapshot of the graph, must be called after loading it
+	@detail Time Complexity O(V+E) , Space Complexity O(V+E)
+*/
+template<class T>
+void Graph<T>::buildCSR() {
+	unsigned int n_edges = 0;
+	for (Vertex<T> * v : this->vertices)
+		n_edges += v->adjacent.size();
+	this->ch = ContractionHierarchy();
+	this->landmarks = Landmarks();
+	this->tree = DynamicSSSP();
+	this->components = ComponentIndex();
+	this->routes.clear();
+	this->csr.clear(this->counter, n_edges);
+	this->csr_edge.clear();
+	this->csr_edge.reserve(n_edges);
+	for (Vertex<T> * v : this->vertices) {
+		this->csr.setPosition(v->id_mask, v->position);
+		for (pair<long long int , Edge<T> *> p : v->adjacent) {
+			Edge<T> *edge = p.second;
+			edge->csr_index = this->csr.addEdge(v->id_mask, edge->dest->id_mask, edge->weight, 0);
+			this->csr_edge.push_back(edge);
+			this->edgeChanged(edge);
+		}
+	}
+	this->csr.finish();
+}
+
+/**
+	@brief Copies the state of an Edge (cut, full) to the CSR snapshot
+	@param edge Edge that changed
 	@detail Time Complexity O(1) , Space Complexity O(1)
 */
+template<class T>
+void Graph<T>::edgeChanged(Edge<T> *edge) {
+	if (edge->csr_index == NO_EDGE)
+		return;
+	unsigned char flags = (edge->isCut() ? CSRGraph::EDGE_CUT : 0) | (edge->isFull() ? CSRGraph::EDGE_FULL : 0);
+	if (flags == this->csr.getFlags(edge->csr_index))
+		return;
+	this->csr.setFlags(edge->csr_index, flags);
+	if (this->ch.isBuilt())
+		this->ch.edgeChanged(this->csr, edge->csr_index);
+	if (this->tree.isBuilt())
+		this->tree.edgeChanged(this->csr, edge->csr_index);
+	this->components.edgeChanged(this->csr, edge->csr_index);
+}
+
+/**
+	@brief Builds the Contraction Hierarchy of the graph (preprocessing of CONTRACTION_HIERARCHIES)
+	@detail Time Complexity O(V*log(V) + S*d), where S is the number of arcs and d the maximum upward degree, Space Complexity O(S)
+*/
+template<class T>
+void Graph<T>::buildContractionHierarchy() {
+	if (this->csr.getNumVertex() != this->counter)
+		this->buildCSR();
+	this->ch.build(this->csr);
+}
+
+/**
+	@brief Chooses the landmarks of the ALT heuristic and computes their distance tables
+	@detail Time Complexity O(L*(V+E)*log(V)) , Space Complexity O(L*V)
+*/
+template<class T>
+void Graph<T>::buildLandmarks() {
+	if (this->csr.getNumVertex() != this->counter)
+		this->buildCSR();
+	this->landmarks.build(this->csr);
+}
+
+/**
+	@brief Sorts the IDs (from the files) of the vertexes for getVertexByID and getVertexesByID, must be called after adding them
+	@detail Time Complexity O(V*log(V)) , Space Complexity O(V)
+*/
+template <class T>
+void Graph<T>::indexVertexIDs() {
+	vector< pair<T, unsigned int> > table;
+	table.reserve(this->vertices.size());
+	for (Vertex<T> * v : this->vertices)
+		table.push_back( make_pair(v->ID, v->id_mask) );
+	sort(table.begin(), table.end());
+	this->sorted_ids.resize(table.size());
+	this->sorted_masks.resize(table.size());
+	for (unsigned int i = 0; i < table.size(); i++) {
+		this->sorted_ids[i] = table[i].first;
+		this->sorted_masks[i] = table[i].second;
+	}
+}
+
+/**
+	@brief Gets the vertex with an ID from the files
+	@param id ID of the vertex
+	@return Vertex with that ID, nullptr if there is none
+	@detail Time Complexity O(log(V)) , Space Complexity O(1)
+*/
 template <class T>
-Vertex<T>* Graph<T>::getVertexByIDMask(long long int id) const {
-	Vertex<T> * temp = new Vertex<T>(id);
-	auto ret = this->vertexSet.find( temp );
-	delete temp;
-	return *ret;
+Vertex<T>* Graph<T>::getVertexByID(const T &id) const {
+	auto it = lower_bound(this->sorted_ids.begin(), this->sorted_ids.end(), id);
+	if (it == this->sorted_ids.end() || *it != id)
+		return nullptr;
+	return this->vertices[ this->sorted_masks[it - this->sorted_ids.begin()] ];
+}
+
+/**
+	@brief Gets the vertexes with many IDs from the files at once, split between the workers of the pool
+	@param ids IDs of the vertexes
+	@param found Set to the vertex of each ID (same order), nullptr for the IDs with no vertex
+	@detail Time Complexity O(N*log(V)/W), with N ids and W workers , Space Complexity O(N)
+*/
+template <class T>
+void Graph<T>::getVertexesByID(const vector<T> &ids, vector<Vertex<T>*> &found) {
+	found.resize(ids.size());
+	unsigned int n_blocks = (ids.size() + ID_BLOCK - 1) / ID_BLOCK;
+	this->pool.parallelFor(n_blocks, [this, &ids, &found] (unsigned int block, unsigned int) {
+		unsigned long int end = min( (unsigned long int) ids.size(), (unsigned long int) (block + 1) * ID_BLOCK );
+		for (unsigned long int i = (unsigned long int) block * ID_BLOCK; i < end; i++)
+			found[i] = this->getVertexByID(ids[i]);
+	});
+}
+
+/**
+	@brief Searches the CSR snapshot for a path with the chosen algorithm
+	@param algorithm Algorithm to use (ONE_TO_MANY, DYNAMIC_TREE and TRAFFIC_ASSIGNMENT are searched with A*)
+	@param sourc Start vertex (id_mask)
+	@param dest End vertex (id_mask)
+	@param NODES_LIMIT Limits the number of nodes to explore (not used by CONTRACTION_HIERARCHIES)
+	@param route Where the path is written
+	@param worker Worker of the pool running the search, selects the workspaces
+	@detail Only reads the graph, so different workers can search at the same time
+*/
+template<class T>
+void Graph<T>::searchRoute(RoutingAlgorithm algorithm, unsigned int sourc, unsigned int dest, const unsigned long int NODES_LIMIT, Route &route, unsigned int worker) {
+	SearchWorkspace &ws = this->workspaces[worker], &backward = this->backward_workspaces[worker];
+	const CSRGraph &csr = this->csr;
+	route.edges.clear();
+	route.dist = INT_MAX;
+	route.explored = 0;
+	if (sourc == dest) {
+		route.dist = 0;
+		return;
+	}
+	ChordHeuristic to_dest(csr, dest);
+
+	switch (algorithm) {
+	case CONTRACTION_HIERARCHIES:
+		route.dist = this->ch.query(sourc, dest, ws, backward, route.edges, route.explored);
+		break;
+	case BIDIRECTIONAL_ASTAR: {
+		ChordHeuristic from_sourc(csr, sourc); //the chord is symmetric
+		route.dist = bidirectionalAstarSearch(csr, ws, backward, sourc, dest, NODES_LIMIT, to_dest, from_sourc, route.edges, route.explored);
+		break;
+	}
+	case ALT:
+		if (astarSearch(csr, ws, sourc, dest, NODES_LIMIT, Landmarks::Heuristic(this->landmarks, dest), route.explored)) {
+			route.dist = ws.dist[dest];
+			readPath(ws, sourc, dest, route.edges);
+		}
+		break;
+	default: //Algorithm based on http://web.mit.edu/eranki/www/tutorials/search/
+		if (astarSearch(csr, ws, sourc, dest, NODES_LIMIT, to_dest, route.explored)) {
+			route.dist = ws.dist[dest];
+			readPath(ws, sourc, dest, route.edges);
+		}
+	}
 }
 
 /**
-	@brief Searches the graph for a path using A*
+	@brief Searches the graph for a single path with the chosen algorithm (on the calling thread)
+	@param algorithm Algorithm to use
 	@param sourc Pointer to start node
 	@param dest Pointer to end node
 	@param NODES_LIMIT Limits the number of nodes to explore (should be equal to number of nodes reachable from start)
-	@detail Time Complexity O( (V+E)*log(V) ), Space Complexity ( 2*V )
-	@detail Algorithm based on http://web.mit.edu/eranki/www/tutorials/search/
-	@detail Time Complexity based on https://stackoverflow.com/questions/11070248/a-time-complexity#comment41548859_11070326
+	@param route Where the path is written
+*/
+template<class T>
+void Graph<T>::findPath(RoutingAlgorithm algorithm, Vertex<T> *sourc, Vertex<T> *dest, const unsigned long int NODES_LIMIT, Route &route) {
+	if (this->csr.getNumVertex() != this->counter)
+		this->buildCSR();
+	if (algorithm == CONTRACTION_HIERARCHIES && !this->ch.isBuilt())
+		this->buildContractionHierarchy();
+	else if (algorithm == ALT && !this->landmarks.isBuilt())
+		this->buildLandmarks();
+	this->workspaces.resize(this->pool.size());
+	this->backward_workspaces.resize(this->pool.size());
+	this->searchRoute(algorithm, sourc->id_mask, dest->id_mask, NODES_LIMIT, route, 0);
+}
+
+/**
+	@brief Finds a path for every car of cars_destination, without committing them
+	@param algorithm Algorithm to use
+	@param sourc Pointer to start node (origin of the cut road)
+	@param NODES_LIMIT Limits the number of nodes to explore
+	@detail The searches run in parallel against the current state of the roads, each worker with its own workspaces.
+	Cars whose destination is in a component that cannot be reached from sourc are rejected without searching.
+	ONE_TO_MANY grows a single shortest path tree instead, stopping when the last destination is settled.
+	DYNAMIC_TREE only makes sure its tree is rooted at sourc, the paths are read from it when committed.
+	TRAFFIC_ASSIGNMENT routes all the cars together on congestion aware costs, within the room left on each road.
+	@detail Time Complexity O( C*(V+E)*log(V) / W ), where C is the number of cars and W the number of workers
 */
 template<class T>
-void Graph<T>::Astar(Vertex<T> *sourc, Vertex<T> *dest, const unsigned long int NODES_LIMIT) {
-	bool ignore = false;
-	for (Vertex<T> * v : this->vertexSet) {
-		v->path = NULL; v->dist = INT_INFINITY; v->process = false;
+void Graph<T>::planRoutes(RoutingAlgorithm algorithm, Vertex<T> *sourc, const unsigned long int NODES_LIMIT) {
+	if (this->csr.getNumVertex() != this->counter)
+		this->buildCSR();
+	if (algorithm == CONTRACTION_HIERARCHIES && !this->ch.isBuilt())
+		this->buildContractionHierarchy();
+	else if (algorithm == ALT && !this->landmarks.isBuilt())
+		this->buildLandmarks();
+	this->workspaces.resize(this->pool.size());
+	this->backward_workspaces.resize(this->pool.size());
+
+	vector<unsigned int> &targets = this->route_dest;
+	targets.clear();
+	for (Vertex<T> *v : this->cars_destination)
+		targets.push_back(v->id_mask);
+	this->routes.assign(targets.size(), Route());
+
+	this->components.update(this->csr);
+	unsigned long int reachable = this->components.markReachable(this->csr, sourc->id_mask);
+	unsigned int largest = 0, singletons = 0, rejected = 0;
+	for (unsigned int c = 0; c < this->components.getNumComponents(); c++) {
+		largest = max(largest, this->components.getComponentSize(c));
+		singletons += (this->components.getComponentSize(c) == 1);
 	}
-	sourc->dist = 0;
-	list<Vertex<T> *> closed_list;
-	vector<Vertex<T> *> open_list;
-	open_list.push_back(sourc);
-
-	while ( !open_list.empty() ){
-		make_heap( open_list.begin() , open_list.end() , [] (Vertex<T> *v1 , Vertex<T> *v2) { return v1->getDist() > v2->getDist(); } );
-		Vertex<T> curr = *(open_list.front()) , *curr_ptr = open_list.front();
-		open_list.erase(open_list.begin());
-		if (curr.id_mask == dest->id_mask){ //Here to guarantee optimal path
-			cout << "	!SUCESS!	\n";
-			cout << "	A* explored " << closed_list.size() << " nodes\n";
-			return;
+	for (unsigned int dest : targets)
+		rejected += !this->components.canReach(dest);
+	cout << "	" << this->components.getNumComponents() << " strongly connected components (largest " << largest << " nodes, "
+			<< singletons << " single nodes), " << reachable << " nodes reachable from " << sourc->getIDMask() << ", "
+			<< rejected << " cars cannot reach their destination\n";
+
+	if (algorithm == DYNAMIC_TREE) {
+		if (!this->tree.isBuilt() || this->tree.getSource() != sourc->id_mask) {
+			this->tree.build(this->csr, sourc->id_mask);
+			cout << "	Built the shortest path tree of " << sourc->getIDMask() << "\n";
 		}
+		else
+			cout << "	Reusing the shortest path tree of " << sourc->getIDMask() << ", repaired " << this->tree.takeRepaired() << " nodes\n";
+		return;
+	}
+
+	if (algorithm == TRAFFIC_ASSIGNMENT) {
+		vector<unsigned int> capacity(this->csr_edge.size());
+		for (unsigned int e = 0; e < capacity.size(); e++)
+			capacity[e] = this->csr_edge[e]->max_number_cars - this->csr_edge[e]->curr_number_cars;
+		vector< pair<unsigned int, unsigned int> > trips;
+		for (unsigned int dest : targets)
+			trips.push_back(make_pair((unsigned int) sourc->id_mask, dest));
+		TrafficAssignment::Stats stats = this->assignment.assign(this->csr, capacity, trips, this->pool, this->routes);
+		cout << "	Traffic assignment ran " << stats.iterations << " iterations, relative gap " << stats.relative_gap
+				<< ", total cost " << stats.total_cost << ", " << stats.trees << " trees to route the cars, "
+				<< stats.unreachable << " cars without a path\n";
+		return;
+	}
 
-		for ( pair<long long int,Edge<T>*> p : curr.adjacent){
-			Edge<T> *edge = p.second;  Vertex<T> *adjacent = edge->dest;
-			if (edge->curr_number_cars == edge->max_number_cars || edge->isCut()) //ignore if street full
-				continue;
-
-			int dist = curr_ptr->dist + edge->weight + //G
-							 calculateDistance(adjacent,dest); //H
-			auto o_it = open_list.begin();
-			for ( ; o_it != open_list.end() ; o_it++)
-				if ( (*o_it)->id_mask == adjacent->id_mask ){ //if vertex is in open list
-					if ( (*o_it)->dist <= dist){
-						ignore = true;
-						break;
-					}
-					else{ //current path better than the one in openlist
-						(*o_it)->dist = dist;
-						(*o_it)->path = curr_ptr;
-						break;
-					}
-				}
-			if ( ignore ){ ignore = false; continue; }
-
-			for (Vertex<T> *temp : closed_list)
-				if ((temp->id_mask == adjacent->id_mask) && (temp->dist <= dist)){
-					ignore = true;
-					break;
-				}
-			if ( ignore ){ ignore = false; continue; }
-
-			if( o_it == open_list.end()){ //node not in open_list
-				adjacent->dist = dist;
-				open_list.push_back( adjacent );
-				adjacent->path = curr_ptr;
+	if (algorithm == ONE_TO_MANY) {
+		SearchWorkspace &tree = this->workspaces[0];
+		unsigned long int explored = 0;
+		vector<unsigned int> reachable_targets; //unreachable ones would make the search settle everything
+		for (unsigned int dest : targets)
+			if (this->components.canReach(dest))
+				reachable_targets.push_back(dest);
+		unsigned int settled = oneToManySearch(this->csr, tree, sourc->id_mask, reachable_targets, NODES_LIMIT, explored);
+		cout << "	One to many settled " << settled << " destinations, explored " << explored << " nodes\n";
+		for (unsigned int car = 0; car < targets.size(); car++) {
+			Route &route = this->routes[car];
+			if (targets[car] == sourc->id_mask)
+				route.dist = 0;
+			else if (tree.isClosed(targets[car])) {
+				route.dist = tree.dist[targets[car]];
+				readPath(tree, sourc->id_mask, targets[car], route.edges);
 			}
 		}
-		if ( !curr.process){ //if node not yet processed add to closed list
-			curr.process = true;
-			closed_list.push_back(curr_ptr);
-		}
-		if(closed_list.size() >= NODES_LIMIT ){ //if no path was found
-			dest->path = NULL;
-			cout << "	A* explored " << closed_list.size() << " nodes\n";
-			return;
-		}
+		return;
+	}
+
+	this->pool.parallelFor(targets.size(), [this, algorithm, sourc, NODES_LIMIT, &targets] (unsigned int car, unsigned int worker) {
+		if (this->components.canReach(targets[car])) //otherwise no need to search
+			this->searchRoute(algorithm, sourc->id_mask, targets[car], NODES_LIMIT, this->routes[car], worker);
+	});
+}
+
+/**
+	@brief Commits the path planned for a car, adding it to the number of cars of its edges
+	@param car Position of the car in cars_destination
+	@param algorithm Algorithm used by planRoutes
+	@param sourc Pointer to start node (origin of the cut road)
+	@param NODES_LIMIT Limits the number of nodes to explore
+	@return The path committed (not found if the car cannot reach its destination)
+	@detail Cars must be committed in order. If the cars committed before filled up an edge of the path,
+	the car is searched again; otherwise the planned path is still a shortest path, as filling up roads only removes options.
+	This keeps the result the same as routing the cars one by one.
+	With DYNAMIC_TREE the path is read from the tree, which the previous commits already repaired; explored is then the
+	number of nodes those repairs settled.
+	@detail Time Complexity O(N) if the path is still free, Space Complexity O(1)
+*/
+template<class T>
+const Route &Graph<T>::commitRoute(unsigned int car, RoutingAlgorithm algorithm, Vertex<T> *sourc, const unsigned long int NODES_LIMIT) {
+	Route &route = this->routes[car];
+	if (algorithm == DYNAMIC_TREE) {
+		route.dist = this->tree.readPath(this->route_dest[car], route.edges);
+		route.explored = this->tree.takeRepaired();
 	}
-	cout << "	A* explored " << closed_list.size() << " nodes\n";
+	bool blocked = false;
+	for (unsigned int e : route.edges)
+		blocked = blocked || this->csr.isBlocked(e);
+	if (blocked)
+		this->searchRoute(algorithm, sourc->id_mask, this->route_dest[car], NODES_LIMIT, route, 0);
+	if (route.found())
+		this->updatePath(route);
+	return route;
 }
 
 #endif /* GRAPH_H */
@@ -0,0 +1,162 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <vector>
+#include <utility>
+#include <climits>
+#include <cstddef>
+
+/**
+	@brief Indexed d-ary min-heap over the integer ids [0, capacity)
+	@detail Every id knows its position in the heap, so membership tests are O(1) and
+	decreaseKey is O(log_D(n)) instead of rebuilding the heap
+	@var heap Pairs (key, id) ordered as a D-ary heap
+	@var position Position of each id inside heap, or NOT_IN_HEAP if absent
+*/
+template<class Key, unsigned int D = 4>
+class IndexedHeap {
+	std::vector< std::pair<Key, unsigned int> > heap;
+	std::vector<unsigned int> position;
+
+public:
+	static constexpr unsigned int NOT_IN_HEAP = UINT_MAX;
+
+	IndexedHeap(size_t capacity = 0) : position(capacity, NOT_IN_HEAP) {}
+
+	/**
+		@brief Changes the range of ids accepted by the heap, emptying it
+		@param capacity Number of distinct ids
+		@detail Time Complexity O(capacity) , Space Complexity O(capacity)
+	*/
+	void resize(size_t capacity) {
+		this->heap.clear();
+		this->position.assign(capacity, NOT_IN_HEAP);
+	}
+
+	inline bool empty() const { return this->heap.empty(); }
+	inline size_t size() const { return this->heap.size(); }
+	inline size_t capacity() const { return this->position.size(); }
+	inline bool contains(unsigned int id) const { return this->position[id] != NOT_IN_HEAP; }
+	inline unsigned int top() const { return this->heap.front().second; }
+	inline Key topKey() const { return this->heap.front().first; }
+	inline Key getKey(unsigned int id) const { return this->heap[this->position[id]].first; }
+
+	/**
+		@brief Inserts an id that is not yet in the heap
+		@detail Time Complexity O(log(n)) , Space Complexity O(1)
+	*/
+	void push(unsigned int id, Key key) {
+		this->position[id] = this->heap.size();
+		this->heap.emplace_back(key, id);
+		this->siftUp(this->heap.size() - 1);
+	}
+
+	/**
+		@brief Lowers the key of an id already in the heap
+		@detail Time Complexity O(log(n)) , Space Complexity O(1)
+	*/
+	void decreaseKey(unsigned int id, Key key) {
+		size_t pos = this->position[id];
+		this->heap[pos].first = key;
+		this->siftUp(pos);
+	}
+
+	/**
+		@brief Changes the key of an id already in the heap, in either direction
+		@detail Time Complexity O(D*log(n)) , Space Complexity O(1)
+	*/
+	void changeKey(unsigned int id, Key key) {
+		size_t pos = this->position[id];
+		Key old = this->heap[pos].first;
+		this->heap[pos].first = key;
+		if (key < old)
+			this->siftUp(pos);
+		else
+			this->siftDown(pos);
+	}
+
+	/**
+		@brief Inserts the id, or lowers its key if the new one is smaller
+		@return True if the heap changed
+		@detail Time Complexity O(log(n)) , Space Complexity O(1)
+	*/
+	bool pushOrDecrease(unsigned int id, Key key) {
+		if (!this->contains(id)) {
+			this->push(id, key);
+			return true;
+		}
+		if (key < this->getKey(id)) {
+			this->decreaseKey(id, key);
+			return true;
+		}
+		return false;
+	}
+
+	/**
+		@brief Removes the id with the smallest key
+		@return The removed id
+		@detail Time Complexity O(D*log(n)) , Space Complexity O(1)
+	*/
+	unsigned int pop() {
+		unsigned int id = this->heap.front().second;
+		this->position[id] = NOT_IN_HEAP;
+		if (this->heap.size() > 1) {
+			this->heap.front() = this->heap.back();
+			this->position[this->heap.front().second] = 0;
+			this->heap.pop_back();
+			this->siftDown(0);
+		}
+		else
+			this->heap.pop_back();
+		return id;
+	}
+
+	/**
+		@brief Empties the heap
+		@detail Only the ids still in the heap are touched, Time Complexity O(n) , Space Complexity O(1)
+	*/
+	void clear() {
+		for (const std::pair<Key, unsigned int> &p : this->heap)
+			this->position[p.second] = NOT_IN_HEAP;
+		this->heap.clear();
+	}
+
+private:
+	void siftUp(size_t pos) {
+		std::pair<Key, unsigned int> elem = this->heap[pos];
+		while (pos > 0) {
+			size_t parent = (pos - 1) / D;
+			if ( !(elem.first < this->heap[parent].first) )
+				break;
+			this->heap[pos] = this->heap[parent];
+			this->position[this->heap[pos].second] = pos;
+			pos = parent;
+		}
+		this->heap[pos] = elem;
+		this->position[elem.second] = pos;
+	}
+
+	void siftDown(size_t pos) {
+		std::pair<Key, unsigned int> elem = this->heap[pos];
+		size_t n = this->heap.size();
+		while (true) {
+			size_t first = pos * D + 1;
+			if (first >= n)
+				break;
+			size_t last = (first + D < n) ? first + D : n;
+			size_t best = first;
+			for (size_t c = first + 1; c < last; c++)
+				if (this->heap[c].first < this->heap[best].first)
+					best = c;
+			if ( !(this->heap[best].first < elem.first) )
+				break;
+			this->heap[pos] = this->heap[best];
+			this->position[this->heap[pos].second] = pos;
+			pos = best;
+		}
+		this->heap[pos] = elem;
+		this->position[elem.second] = pos;
+	}
+};
+
+#endif /* INDEXED_HEAP_H */
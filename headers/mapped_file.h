@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+	@brief Read only memory mapping of a whole file
+	@var data Start of the mapping, nullptr if the file could not be mapped
+	@var size Size of the file
+*/
+class MappedFile {
+	const char *data = nullptr;
+	size_t size = 0;
+public:
+	MappedFile(const char *file_name);
+	~MappedFile();
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	inline bool isOpen() const { return this->data != nullptr; }
+	inline const char *getData() const { return this->data; }
+	inline size_t getSize() const { return this->size; }
+};
+
+/**
+	@brief Size of a file in bytes, 0 if it does not exist
+*/
+uint64_t fileSize(const char *file_name);
+
+#endif /* MAPPED_FILE_H */
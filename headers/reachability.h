@@ -0,0 +1,52 @@
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+
+#include "csr.h"
+#include "worker_pool.h"
+#include <vector>
+#include <cstdint>
+
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+/**
+	@brief Set of the vertexes reachable from a root, found with a parallel direction-optimizing BFS
+	@detail Levels with a small frontier are expanded top-down, each worker claiming new vertexes with an atomic or
+	on the bitmap. When the frontier has more edges than BFS_ALPHA-th of the edges left unexplored the search
+	switches to bottom-up, where every unvisited vertex looks for a parent in the frontier through its incoming
+	edges and stops at the first one. It goes back to top-down when the frontier drops below BFS_BETA-th of
+	the vertexes (Beamer et al.). Every edge is followed, cut and full roads included.
+	@var visited Bitmap of the vertexes reached, bit v%64 of word v/64
+	@var frontier Vertexes reached in the last level
+	@var frontier_bits Bitmap of frontier, used by the bottom-up levels
+	@var next Vertexes reached by each worker in the current level
+	@var count Number of vertexes reached, root included
+*/
+class Reachability {
+	std::vector<uint64_t> visited;
+	std::vector<unsigned int> frontier;
+	std::vector<uint64_t> frontier_bits;
+	std::vector< std::vector<unsigned int> > next;
+	unsigned long int count = 0;
+
+public:
+	/**
+	 * @brief Finds the vertexes reachable from root
+	 * @param[in] graph Graph to explore (must have its incoming edges built)
+	 * @param[in] root Start vertex
+	 * @param[in] pool Workers to run on
+	 * @return Number of vertexes reachable from root, root included
+	 * @detail Time Complexity O((V+E)/W) per level, with W workers, Space Complexity O(V)
+	 */
+	unsigned long int explore(const CSRGraph &graph, unsigned int root, WorkerPool &pool);
+
+	inline unsigned long int getCount() const { return this->count; }
+	inline const std::vector<uint64_t> &getBitmap() const { return this->visited; }
+	inline bool isReachable(unsigned int v) const { return (this->visited[v >> 6] >> (v & 63)) & 1; }
+
+private:
+	void topDown(const CSRGraph &graph, WorkerPool &pool);
+	void bottomUp(const CSRGraph &graph, WorkerPool &pool);
+};
+
+#endif /* REACHABILITY_H */
@@ -0,0 +1,95 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include "csr.h"
+#include "search.h"
+#include <vector>
+
+/**
+	@brief Strongly connected components of the roads that are not cut, kept up to date as roads are cut
+	@detail Built with an iterative Tarjan. Cutting a road inside a component runs Tarjan again over that component only,
+	splitting it; cutting a road between components changes nothing. Restoring a road may merge components, so the
+	index is rebuilt the next time it is used. Full roads are ignored, they only slow cars down for a while.
+	The condensation is kept as the roads leaving each component, so the components reachable from a vertex are
+	found without visiting the inside of any of them, and a destination is then rejected in O(1).
+	@var comp Component of each vertex
+	@var members Vertexes of each component
+	@var exits Roads leaving each component
+	@var cut Whether each road was cut the last time the index saw it
+	@var stale Whether the index must be rebuilt before being used
+	@var scope Generation in which each vertex was part of the last Tarjan run
+	@var index Discovery order of each vertex in the last Tarjan run
+	@var low Smallest discovery order reachable from each vertex in the last Tarjan run
+	@var on_stack Whether each vertex is in the stack of the Tarjan run
+	@var generation Generation of the last Tarjan run
+	@var reached Generation in which each component was last found reachable by markReachable
+	@var reach_generation Generation of the last markReachable
+*/
+class ComponentIndex {
+	std::vector<unsigned int> comp;
+	std::vector< std::vector<unsigned int> > members;
+	std::vector< std::vector<unsigned int> > exits;
+	std::vector<char> cut;
+	bool stale = true;
+	std::vector<unsigned int> scope;
+	std::vector<unsigned int> index;
+	std::vector<unsigned int> low;
+	std::vector<char> on_stack;
+	unsigned int generation = 0;
+	std::vector<unsigned int> reached;
+	unsigned int reach_generation = 0;
+
+public:
+	/**
+	 * @brief Computes the components from scratch
+	 * @param[in] graph Graph to index
+	 * @detail Time Complexity O(V+E), Space Complexity O(V+E)
+	 */
+	void build(const CSRGraph &graph);
+
+	/**
+	 * @brief Rebuilds the index if it is stale
+	 */
+	inline void update(const CSRGraph &graph) { if (this->stale) this->build(graph); }
+
+	/**
+	 * @brief Updates the components after a road was cut or restored
+	 * @param[in] graph Graph the index was built from, with the new flags of the road
+	 * @param[in] edge CSR edge that changed
+	 * @detail Time Complexity O(S+E_S) when the road was inside a component of S vertexes and E_S edges, O(1) otherwise
+	 */
+	void edgeChanged(const CSRGraph &graph, unsigned int edge);
+
+	inline bool isStale() const { return this->stale; }
+	inline unsigned int getNumComponents() const { return this->members.size(); }
+	inline unsigned int getComponent(unsigned int v) const { return this->comp[v]; }
+	inline unsigned int getComponentSize(unsigned int c) const { return this->members[c].size(); }
+
+	/**
+	 * @brief Finds the components reachable from a vertex, to be asked with canReach
+	 * @param[in] graph Graph the index was built from
+	 * @param[in] sourc Start vertex
+	 * @return Number of vertexes reachable from sourc (sourc included)
+	 * @detail Time Complexity O(C+X), where C and X are the components and the roads between them reachable from sourc
+	 */
+	unsigned long int markReachable(const CSRGraph &graph, unsigned int sourc);
+
+	/**
+	 * @brief Whether a vertex is reachable from the last vertex given to markReachable, in O(1)
+	 */
+	inline bool canReach(unsigned int v) const { return this->reached[this->comp[v]] == this->reach_generation; }
+
+private:
+
+	/**
+	 * @brief Runs Tarjan over a set of vertexes, giving new ids to the components found
+	 * @param[in] graph Graph the index was built from
+	 * @param[in] vertices Vertexes to run over, roads leaving them are not followed
+	 * @param[in] reuse Id to give to one of the components found (the one being split), or NO_EDGE
+	 */
+	void tarjan(const CSRGraph &graph, const std::vector<unsigned int> &vertices, unsigned int reuse);
+
+	inline bool isCut(const CSRGraph &graph, unsigned int edge) const { return graph.getFlags(edge) & CSRGraph::EDGE_CUT; }
+};
+
+#endif /* SCC_H */
@@ -0,0 +1,295 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "csr.h"
+#include "indexed_heap.h"
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+const unsigned int NO_EDGE = UINT_MAX;
+
+/**
+	@brief Path found for one car
+	@var edges CSR edges of the path, in order
+	@var dist Length of the path (in m), INT_MAX if no path was found
+	@var explored Number of nodes explored to find it
+*/
+struct Route {
+	std::vector<unsigned int> edges;
+	int dist = INT_MAX;
+	unsigned long int explored = 0;
+
+	inline bool found() const { return this->dist != INT_MAX; }
+};
+
+/**
+	@brief State of one shortest path query, kept apart from the graph
+	@detail The state of a vertex is only valid if its stamp matches the generation of the workspace, so starting
+	a new query just bumps the generation instead of clearing every vertex. Vertexes left over from older queries
+	read as unreached, and a query only pays for the vertexes it touches.
+	@var dist Best known distance (G) from the source to each vertex
+	@var parent Vertex preceding each vertex in the best known path
+	@var parent_edge CSR edge used to reach each vertex in the best known path
+	@var closed Whether the vertex is in the closed list
+	@var stamp Generation in which each vertex was last reached
+	@var generation Generation of the current query
+	@var open_list Open list, indexed by vertex
+*/
+struct SearchWorkspace {
+	std::vector<int> dist;
+	std::vector<unsigned int> parent;
+	std::vector<unsigned int> parent_edge;
+	std::vector<char> closed;
+	std::vector<unsigned int> stamp;
+	unsigned int generation = 0;
+	IndexedHeap<int> open_list;
+
+	/**
+		@brief Prepares the workspace for a new query over n vertexes
+		@detail Time Complexity O(1) amortized (O(V) when n changes or the generation wraps around) , Space Complexity O(V)
+	*/
+	void reset(unsigned int n) {
+		this->open_list.clear();
+		if (this->stamp.size() != n || ++this->generation == 0) {
+			this->open_list.resize(n);
+			this->dist.resize(n);
+			this->parent.resize(n);
+			this->parent_edge.resize(n);
+			this->closed.resize(n);
+			this->stamp.assign(n, 0);
+			this->generation = 1;
+		}
+	}
+
+	inline bool reached(unsigned int v) const { return this->stamp[v] == this->generation; }
+	inline int getDist(unsigned int v) const { return this->reached(v) ? this->dist[v] : INT_MAX; }
+	inline bool isClosed(unsigned int v) const { return this->reached(v) && this->closed[v]; }
+	inline void close(unsigned int v) { this->closed[v] = true; }
+
+	/**
+		@brief Records a new best path to a vertex, reopening it
+		@param v Vertex reached
+		@param d Distance from the source
+		@param from Vertex preceding v (NO_EDGE for the source)
+		@param edge Edge used to reach v (NO_EDGE for the source)
+	*/
+	inline void reach(unsigned int v, int d, unsigned int from, unsigned int edge) {
+		this->stamp[v] = this->generation;
+		this->dist[v] = d;
+		this->parent[v] = from;
+		this->parent_edge[v] = edge;
+		this->closed[v] = false;
+	}
+};
+
+/**
+	@brief Straight line lower bound of the distance between the vertexes and a fixed one, to be used by the searches
+	@detail Only a few multiplies and a square root per call, see chordLowerBound
+	@var graph Graph holding the positions
+	@var target Position of the fixed vertex
+*/
+class ChordHeuristic {
+	const CSRGraph &graph;
+	UnitVector target;
+public:
+	ChordHeuristic(const CSRGraph &graph, unsigned int target) : graph(graph), target(graph.getPosition(target)) {}
+	inline int operator()(unsigned int v) const { return chordLowerBound(this->graph.getPosition(v), this->target); }
+};
+
+/**
+	@brief Reads the path to a vertex from a search tree
+	@param ws Workspace holding the tree
+	@param sourc Root of the tree
+	@param dest Vertex to read the path to (must have been reached)
+	@param path CSR edges of the path, from sourc to dest
+	@detail Time Complexity O(N) , Space Complexity O(1)
+*/
+inline void readPath(const SearchWorkspace &ws, unsigned int sourc, unsigned int dest, std::vector<unsigned int> &path) {
+	path.clear();
+	for (unsigned int v = dest; v != sourc; v = ws.parent[v])
+		path.push_back(ws.parent_edge[v]);
+	std::reverse(path.begin(), path.end());
+}
+
+/**
+	@brief Searches the CSR graph for a path using A*, ignoring blocked (cut or full) edges
+	@param graph Graph to search
+	@param ws Workspace where the search tree is left
+	@param sourc Start vertex
+	@param dest End vertex
+	@param NODES_LIMIT Limits the number of nodes to explore
+	@param heuristic Callable giving a lower bound of the distance from a vertex to dest, INT_MAX if dest cannot be reached from it
+	@param explored Number of nodes closed by the search
+	@return True if a path was found, it can be read backwards from ws.parent_edge[dest]
+	@detail Time Complexity O( (V+E)*log(V) ), Space Complexity O(V)
+*/
+template<class Heuristic>
+bool astarSearch(const CSRGraph &graph, SearchWorkspace &ws, unsigned int sourc, unsigned int dest,
+		unsigned long int NODES_LIMIT, Heuristic heuristic, unsigned long int &explored) {
+	explored = 0;
+	ws.reset(graph.getNumVertex());
+	int h = heuristic(sourc);
+	if (h == INT_MAX)
+		return false;
+	ws.reach(sourc, 0, NO_EDGE, NO_EDGE);
+	ws.open_list.push(sourc, h);
+
+	while ( !ws.open_list.empty() ){
+		unsigned int curr = ws.open_list.pop();
+		if (curr == dest)
+			return true;
+		if ( !ws.isClosed(curr) ){
+			ws.close(curr);
+			explored++;
+		}
+
+		for (unsigned int e = graph.edgesBegin(curr); e < graph.edgesEnd(curr); e++){
+			if (graph.isBlocked(e)) //ignore if street cut or full
+				continue;
+			unsigned int adjacent = graph.getTarget(e);
+			int dist = ws.dist[curr] + graph.getWeight(e); //G
+			if (dist >= ws.getDist(adjacent))
+				continue;
+			ws.reach(adjacent, dist, curr, e);
+			h = heuristic(adjacent); //H
+			if (h != INT_MAX)
+				ws.open_list.pushOrDecrease(adjacent, dist + h); //F = G + H
+		}
+		if (explored >= NODES_LIMIT)
+			return false;
+	}
+	return false;
+}
+
+/**
+	@brief Bidirectional A*, searching forward from sourc and backward (over the incoming edges) from dest
+	@param graph Graph to search
+	@param forward Workspace of the forward search
+	@param backward Workspace of the backward search
+	@param sourc Start vertex
+	@param dest End vertex
+	@param NODES_LIMIT Limits the number of nodes to explore (in both directions)
+	@param to_dest Lower bound of the distance from a vertex to dest, INT_MAX if dest cannot be reached from it
+	@param from_sourc Lower bound of the distance from sourc to a vertex, INT_MAX if it cannot be reached from sourc
+	@param path CSR edges of the path found, from sourc to dest
+	@param explored Number of nodes closed by both searches
+	@return Length of the path, or INT_MAX if there is none
+	@detail Uses the average potentials p(v) = (to_dest(v) - from_sourc(v)) / 2, which keep both searches consistent.
+	Keys are doubled to stay integer: 2*G + to_dest - from_sourc forward, 2*G + from_sourc - to_dest backward,
+	and the search stops as soon as the two smallest keys add up to twice the best path found.
+	@detail Stops early when either side runs out of nodes, which is what happens when dest is behind a cut
+	@detail Time Complexity O( (V+E)*log(V) ), Space Complexity O(V)
+*/
+template<class ToDest, class FromSourc>
+int bidirectionalAstarSearch(const CSRGraph &graph, SearchWorkspace &forward, SearchWorkspace &backward,
+		unsigned int sourc, unsigned int dest, unsigned long int NODES_LIMIT, ToDest to_dest, FromSourc from_sourc,
+		std::vector<unsigned int> &path, unsigned long int &explored) {
+	unsigned int n = graph.getNumVertex(), meet = NO_EDGE;
+	long long best = LLONG_MAX;
+	explored = 0;
+	path.clear();
+	forward.reset(n);
+	backward.reset(n);
+	int h_s = to_dest(sourc), h_t = from_sourc(dest);
+	if (h_s == INT_MAX || h_t == INT_MAX)
+		return INT_MAX;
+	forward.reach(sourc, 0, NO_EDGE, NO_EDGE);
+	forward.open_list.push(sourc, h_s);
+	backward.reach(dest, 0, NO_EDGE, NO_EDGE);
+	backward.open_list.push(dest, h_t);
+
+	while (!forward.open_list.empty() && !backward.open_list.empty()) {
+		if (best != LLONG_MAX && (long long) forward.open_list.topKey() + backward.open_list.topKey() >= 2 * best)
+			break;
+		bool go_forward = forward.open_list.size() <= backward.open_list.size();
+		SearchWorkspace &ws = go_forward ? forward : backward, &other = go_forward ? backward : forward;
+		unsigned int u = ws.open_list.pop();
+		if (!ws.isClosed(u)) {
+			ws.close(u);
+			explored++;
+		}
+
+		unsigned int begin = go_forward ? graph.edgesBegin(u) : graph.reverseBegin(u);
+		unsigned int end = go_forward ? graph.edgesEnd(u) : graph.reverseEnd(u);
+		for (unsigned int i = begin; i < end; i++) {
+			unsigned int e = go_forward ? i : graph.getReverseEdge(i);
+			if (graph.isBlocked(e)) //ignore if street cut or full
+				continue;
+			unsigned int v = go_forward ? graph.getTarget(e) : graph.getReverseSource(i);
+			int dist = ws.dist[u] + graph.getWeight(e); //G
+			if (dist >= ws.getDist(v))
+				continue;
+			ws.reach(v, dist, u, e);
+			if (other.getDist(v) != INT_MAX && (long long) dist + other.dist[v] < best) {
+				best = (long long) dist + other.dist[v];
+				meet = v;
+			}
+			int h_dest = to_dest(v), h_sourc = from_sourc(v);
+			if (h_dest == INT_MAX || h_sourc == INT_MAX) //cannot be on a path from sourc to dest
+				continue;
+			int potential = go_forward ? (h_dest - h_sourc) : (h_sourc - h_dest);
+			ws.open_list.pushOrDecrease(v, 2 * dist + potential);
+		}
+		if (explored >= NODES_LIMIT)
+			return INT_MAX;
+	}
+	if (meet == NO_EDGE)
+		return (sourc == dest) ? 0 : INT_MAX;
+
+	for (unsigned int v = meet; v != sourc; v = forward.parent[v])
+		path.push_back(forward.parent_edge[v]);
+	std::reverse(path.begin(), path.end());
+	for (unsigned int v = meet; v != dest; v = backward.parent[v])
+		path.push_back(backward.parent_edge[v]);
+	return best;
+}
+
+/**
+	@brief Dijkstra from one source that stops as soon as every target is settled
+	@param graph Graph to search
+	@param ws Workspace where the shortest path tree is left
+	@param sourc Start vertex
+	@param targets Vertexes to settle (repetitions allowed)
+	@param NODES_LIMIT Limits the number of nodes to explore
+	@param explored Number of nodes closed by the search
+	@return Number of distinct targets settled, their paths can be read backwards from ws.parent_edge
+	@detail Time Complexity O( (V+E)*log(V) ) for all the targets together, Space Complexity O(V)
+*/
+inline unsigned int oneToManySearch(const CSRGraph &graph, SearchWorkspace &ws, unsigned int sourc,
+		const std::vector<unsigned int> &targets, unsigned long int NODES_LIMIT, unsigned long int &explored) {
+	unsigned int n = graph.getNumVertex(), remaining = 0, settled = 0;
+	std::vector<char> is_target(n, false);
+	for (unsigned int t : targets)
+		if (!is_target[t]) {
+			is_target[t] = true;
+			remaining++;
+		}
+	explored = 0;
+	ws.reset(n);
+	ws.reach(sourc, 0, NO_EDGE, NO_EDGE);
+	ws.open_list.push(sourc, 0);
+
+	while (!ws.open_list.empty() && remaining > 0 && explored < NODES_LIMIT) {
+		unsigned int curr = ws.open_list.pop();
+		ws.close(curr);
+		explored++;
+		if (is_target[curr]) {
+			remaining--;
+			settled++;
+		}
+		for (unsigned int e = graph.edgesBegin(curr); e < graph.edgesEnd(curr); e++) {
+			if (graph.isBlocked(e)) //ignore if street cut or full
+				continue;
+			unsigned int adjacent = graph.getTarget(e);
+			int dist = ws.dist[curr] + graph.getWeight(e);
+			if (dist >= ws.getDist(adjacent))
+				continue;
+			ws.reach(adjacent, dist, curr, e);
+			ws.open_list.pushOrDecrease(adjacent, dist);
+		}
+	}
+	return settled;
+}
+
+#endif /* SEARCH_H */
@@ -0,0 +1,186 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "utilities.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define SNAPSHOT_FILE "rsc/Graph5.snap"
+#define SNAPSHOT_MAGIC "CUTSNAP"
+#define SNAPSHOT_VERSION 1
+
+/**
+	@brief First bytes of a snapshot
+	@var magic SNAPSHOT_MAGIC
+	@var version SNAPSHOT_VERSION, snapshots of other versions are not loaded
+	@var byte_order 0x01020304 as written by the machine that made the snapshot
+	@var n_vertex Number of vertexes (SnapshotVertex after the header)
+	@var n_edges Number of edges (SnapshotEdge after the vertexes)
+	@var names_size Bytes of street names (after the edges)
+	@var source_sizes Sizes of the Nodes, Edges and Streets files the snapshot was made from, a snapshot is stale when they change
+*/
+struct SnapshotHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t n_vertex;
+	uint32_t n_edges;
+	uint64_t names_size;
+	uint64_t source_sizes[3];
+};
+
+/**
+	@brief Vertex of a snapshot, in id_mask order
+	@var id ID of the vertex in the files
+	@var latitude Latitude (in radians)
+	@var longitude Longitude (in radians)
+*/
+struct SnapshotVertex {
+	int64_t id;
+	double latitude;
+	double longitude;
+};
+
+/**
+	@brief Edge of a snapshot, grouped by origin in id_mask order (the order of the CSR snapshot)
+	@var sourc id_mask of the origin
+	@var dest id_mask of the destination
+	@var id ID of the edge in the files (negative for the way back of two way streets)
+	@var weight Length (in m)
+	@var name_offset Position of the street name in the names
+	@var name_size Length of the street name, 0 if the edge has no street
+	@var two_ways Whether the street is two ways
+*/
+struct SnapshotEdge {
+	uint32_t sourc;
+	uint32_t dest;
+	int64_t id;
+	uint32_t weight;
+	uint32_t name_offset;
+	uint32_t name_size;
+	uint32_t two_ways;
+};
+
+/**
+	@brief Sizes of the text files the graph is loaded from, in the order of SnapshotHeader::source_sizes
+*/
+void sourceSizes(uint64_t sizes[3]);
+
+/**
+	@brief Writes the graph to a snapshot
+	@param graph Graph to write (loaded from the text files)
+	@param file_name Where to write it
+	@return Whether the snapshot was written
+	@detail Time Complexity O(V+E) , Space Complexity O(V+E)
+*/
+template<class T>
+bool saveSnapshot(Graph<T> &graph, const char *file_name) {
+	vector<SnapshotVertex> out_vertices;
+	vector<SnapshotEdge> out_edges;
+	string names;
+	for (unsigned long int i = 0; i < graph.getCounter(); i++) {
+		Vertex<T> *v = graph.getVertexByIDMask(i);
+		SnapshotVertex sv;
+		sv.id = v->getID();
+		sv.latitude = v->getLatitude();
+		sv.longitude = v->getLongitude();
+		out_vertices.push_back(sv);
+		for (pair<long long int, Edge<T>*> p : v->getAdjacent()) {
+			Edge<T> *edge = p.second;
+			SnapshotEdge se;
+			se.sourc = v->getIDMask();
+			se.dest = edge->getDest()->getIDMask();
+			se.id = edge->getID();
+			se.weight = edge->getWeight();
+			se.name_offset = names.size();
+			se.name_size = edge->getName().size();
+			se.two_ways = edge->getTwoWays();
+			names += edge->getName();
+			out_edges.push_back(se);
+		}
+	}
+
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	strncpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.byte_order = 0x01020304;
+	header.n_vertex = out_vertices.size();
+	header.n_edges = out_edges.size();
+	header.names_size = names.size();
+	sourceSizes(header.source_sizes);
+
+	ofstream file(file_name, ios::binary | ios::trunc);
+	if (!file.is_open())
+		return false;
+	file.write((const char *) &header, sizeof(header));
+	file.write((const char *) out_vertices.data(), out_vertices.size() * sizeof(SnapshotVertex));
+	file.write((const char *) out_edges.data(), out_edges.size() * sizeof(SnapshotEdge));
+	file.write(names.data(), names.size());
+	return file.good();
+}
+
+/**
+	@brief Loads the graph from a snapshot, reading the mapped file in place
+	@param graph Empty graph to load into
+	@param file_name Snapshot to load
+	@return Whether the snapshot was loaded (false if it is missing, of another version or made from other files)
+	@detail Nothing is parsed or measured: vertexes, edges, weights and names come straight from the mapping.
+	The trie and the name index are built from the names, and the CSR snapshot at the end.
+	@detail Time Complexity O(V+E) , Space Complexity O(1) besides the graph
+*/
+template<class T>
+bool loadSnapshot(Graph<T> &graph, const char *file_name) {
+	MappedFile file(file_name);
+	if (!file.isOpen() || file.getSize() < sizeof(SnapshotHeader))
+		return false;
+	const SnapshotHeader *header = (const SnapshotHeader *) file.getData();
+	uint64_t sizes[3];
+	sourceSizes(sizes);
+	if (strncmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || header->version != SNAPSHOT_VERSION
+			|| header->byte_order != 0x01020304 || memcmp(header->source_sizes, sizes, sizeof(sizes)) != 0)
+		return false;
+	size_t expected = sizeof(SnapshotHeader) + header->n_vertex * sizeof(SnapshotVertex)
+			+ header->n_edges * sizeof(SnapshotEdge) + header->names_size;
+	if (file.getSize() != expected)
+		return false;
+
+	const SnapshotVertex *vertices = (const SnapshotVertex *) (file.getData() + sizeof(SnapshotHeader));
+	const SnapshotEdge *edges = (const SnapshotEdge *) (vertices + header->n_vertex);
+	const char *names = (const char *) (edges + header->n_edges);
+
+	graph.initializeSet(header->n_vertex + 1);
+	for (unsigned int i = 0; i < header->n_vertex; i++) {
+		Vertex<T> *v = graph.createVertex(vertices[i].id, vertices[i].latitude, vertices[i].longitude);
+		updateBounds(v);
+		graph.addVertex(v);
+	}
+	graph.indexVertexIDs();
+	for (unsigned int i = 0; i < header->n_edges; i++) {
+		const SnapshotEdge &se = edges[i];
+		Vertex<T> *sourc = graph.getVertexByIDMask(se.sourc), *dest = graph.getVertexByIDMask(se.dest);
+		if (sourc == nullptr || dest == nullptr)
+			continue;
+		Edge<T> *edge = graph.createEdge(dest, se.id, se.weight);
+		edge->setSourc(sourc);
+		edge->setTwoWays(se.two_ways);
+		sourc->addEdge(edge);
+		if (se.name_size == 0 || (uint64_t) se.name_offset + se.name_size > header->names_size)
+			continue;
+		string name(names + se.name_offset, se.name_size);
+		edge->setName(name);
+		transform(name.begin(), name.end(), name.begin(), ::toupper);
+		graph.insertNameToEdge(name, edge);
+		graph.insertWordToTrie(name);
+	}
+	graph.buildTrie();
+	graph.buildCSR();
+	return true;
+}
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,69 @@
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+#include "worker_pool.h"
+#include <vector>
+#include <string>
+
+#define CHUNKS_PER_WORKER 4
+
+/**
+	@brief Line of the Nodes file (nodeID;latitudeDegrees;longitudeDegrees;longitudeRadians;latitudeRadians)
+	@var id ID of the node
+	@var latitude Latitude (in radians)
+	@var longitude Longitude (in radians)
+*/
+struct NodeRecord {
+	long long int id;
+	double latitude;
+	double longitude;
+};
+
+/**
+	@brief Line of the Edges file (edgeID;node1ID;node2ID;)
+	@var id ID of the edge (shared by every piece of the same road)
+	@var sourc ID of the origin node
+	@var dest ID of the destination node
+*/
+struct EdgeRecord {
+	long long int id;
+	long long int sourc;
+	long long int dest;
+};
+
+/**
+	@brief Line of the Streets file (edgeID;streetName;isTwoWays)
+	@var id ID of the edges of the street
+	@var name Name of the street
+	@var two_ways Whether the street is two ways
+*/
+struct StreetRecord {
+	long long int id;
+	std::string name;
+	bool two_ways;
+};
+
+/**
+ * @brief Parses the Nodes file in parallel
+ * @param[in] file_name File to parse
+ * @param[in] pool Workers to run on
+ * @param[out] records One record per line, in the order of the file
+ * @return Whether the file could be mapped and every line parsed
+ * @detail The file is mapped and split in CHUNKS_PER_WORKER chunks per worker at line boundaries. The workers count
+ * the lines of every chunk, so records is sized once and each chunk knows where its records go, and then parse
+ * the chunks straight into records with from_chars.
+ * @detail Time Complexity O(N/W), with N bytes and W workers, Space Complexity O(lines)
+ */
+bool parseNodes(const char *file_name, WorkerPool &pool, std::vector<NodeRecord> &records);
+
+/**
+ * @brief Parses the Edges file in parallel (see parseNodes)
+ */
+bool parseEdges(const char *file_name, WorkerPool &pool, std::vector<EdgeRecord> &records);
+
+/**
+ * @brief Parses the Streets file in parallel (see parseNodes)
+ */
+bool parseStreets(const char *file_name, WorkerPool &pool, std::vector<StreetRecord> &records);
+
+#endif /* TEXT_PARSER_H */
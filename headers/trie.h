@@ -1,14 +1,17 @@
 #ifndef TRIE_H
 #define TRIE_H
 
-#include <list>
-#include <mutex>
-#include <thread>
 #include <string>
 #include <vector>
 #include <queue>
 #include <cctype>
+#include <cstdint>
+#include <climits>
 #include <algorithm>
+#include <set>
+#include <mutex>
+#include "work_stealing_pool.h"
+#include "edit_distance.h"
 
 #define ARR_SIZE 37
 #define ALPHABET_SIZE 26
@@ -17,17 +20,50 @@
 #define ALPHABET_BEGINNING 65
 #define NUMBER_BEGGINING 48
 
+#define NO_NODE UINT32_MAX
+
+/**
+	@brief Node of the radix tree: a run of characters with no branch, and the nodes that follow it
+	@var children Bitmap of the first characters of the children, bit charToArrPos(c) for character c
+	@var first_child Index of the first child, the children are contiguous and in the order of their bits,
+	so the child starting with c is first_child + popcount of the bits below c
+	@var label_offset Start of the characters of the node in the labels of the trie
+	@var label_size Number of characters of the node
+	@var eow Whether a word ends at the end of this node
+*/
+struct radix_node_t {
+	uint64_t children = 0;
+	uint32_t first_child = NO_NODE;
+	uint32_t label_offset = 0;
+	uint16_t label_size = 0;
+	bool eow = false;
+};
 
-struct node_t{
-	bool eow;
-	node_t *next = nullptr;
+/**
+	@brief Word found by an approximate search
+	@var word The word, in upper case
+	@var distance Edit distance to the word searched
+*/
+struct fuzzy_match_t {
+	std::string word;
+	unsigned int distance;
 };
 
-unsigned char charToArrPos(char chr);
+struct FuzzySearch;
 
+/**
+	@brief Path-compressed radix tree of the street names
+	@var nodes Nodes of the tree, the root first and every group of siblings contiguous
+	@var labels Characters of all the nodes
+	@var staged Words inserted since the last build
+	@var pool Workers of the approximate searches
+*/
 class Trie{
+	std::vector<radix_node_t> nodes;
+	std::string labels;
+	std::vector<std::string> staged;
+	mutable WorkStealingPool pool;
 public:
-	node_t root;
 
 	/**
 	 * @brief Default constructor
@@ -35,12 +71,20 @@ public:
 	Trie();
 
 	/**
-	 * @brief Insert a word into the Trie
+	 * @brief Insert a word into the Trie (searchable after the next build)
 	 * @param[in] word Word to insert into the trie
-	 * @detail Time Complexity O(m), where m is string length, Space Complexity O(1)
+	 * @detail Time Complexity O(m), where m is string length, Space Complexity O(m)
 	 */
 	void insertWord(const std::string &word);
 
+	/**
+	 * @brief Rebuilds the radix tree with the words inserted since the last build
+	 * @detail The words are sorted, so every node is the longest common prefix of a range of them and its children
+	 * can be laid out next to each other, level by level. Time Complexity O(W*log(W)*m), for W words of length m,
+	 * Space Complexity O(N+L), N nodes with L characters in total
+	 */
+	void build();
+
 	/**
 	 * @brief Searches for the given string
 	 * @param[in] word Word to search for
@@ -50,76 +94,69 @@ public:
 	bool exactWordSearch(std::string &word) const;
 
 	/**
-	 * @brief Approximate string matching wrapper
+	 * @brief Approximate string matching, the k words closest to a word
 	 * @param[in] word Word to search for matches
-	 * @return List containing the results
+	 * @param[in] max_distance Largest edit distance of a match
+	 * @param[in] k Maximum number of matches
+	 * @return The matches, by edit distance (case insensitive) and then word. Words tied with the last one may be left out
+	 * @detail Walks the trie carrying a column of the edit distance DP table, bit-parallel, pruning the subtrees that cannot
+	 * beat the k-th closest word found so far, so it stops as soon as k words are found at the best distance left.
+	 * Time Complexity O(V*m/64), V visited characters of the trie and m the word length, Space Complexity O(k+V*m/64)
 	 */
-	std::list<std::string> *approximateWordSearch(std::string &word) const;
+	std::vector<fuzzy_match_t> approximateWordSearch(const std::string &word, unsigned int max_distance, size_t k) const;
 
-private:
-
-	/**
-	 * @brief Finds the closest End Of Word from the node given
-	 * @param[in] arr Starting node
-	 * @param[out] depth Maximum depth to search
-	 * @return The node of the closest EOW
-	 * @detail Based on BFS algorithm, Time Complexity O(m), where m is the number of characters in the subtrie, Space Complexity O(m)
-	 */
-	node_t *closestEOW(node_t *arr, unsigned int &depth) const;
-
-	/**
-	 * @brief Searches for the first occurrence of the next existant character in the subtrie
-	 * @param[in] word The remainder of the word to search, usually a substring of a string
-	 * @param[in] arr The node to start looking
-	 * @param[out] max_depth Limits the depth of the search, also used to check how many characters were advanced
-	 * @return The node which contains the first found character
-	 * @detail Based on Breadth First Search
-	 */
-	node_t *findWordInSubtrie(const std::string &word, node_t *arr, unsigned int *max_depth) const;
+	inline size_t getNumNodes() const { return this->nodes.size(); }
+	inline size_t getMemoryUsage() const { return this->nodes.capacity() * sizeof(radix_node_t) + this->labels.capacity(); }
 
+private:
 
 	/**
-	 * @brief Finds the initial estimated edit distances
-	 * @param[in] word Word to search for edit distance
-	 * @return Estimated edit distance
+	 * @brief First candidate of an approximate search, an upper bound of the edit distance to the closest word
+	 * @param[in] pattern Word to search for edit distance, in upper case
+	 * @param[out] closest The word reached by always descending into the child closest to word
+	 * @return Edit distance to closest, UINT_MAX if the trie is empty
+	 * @detail Time Complexity O(d*c*l*m/64), for d levels of c children of l characters and m the word length, Space Complexity O(m/64)
 	 */
-	unsigned int findInitK(const std::string &word) const;
+	unsigned int findInitK(const MyersPattern &pattern, std::string &closest) const;
 
 	/**
-	 * @brief Heart of approximate string matching
-	 * @param[in] word Word to find match
-	 * @param[in] pref Will contain the current preffix of the thread
-	 * @param[out] min_dist The current minimum string matching distance
-	 * @param[out] results Will hold the results of the matching
-	 * @detail Launches multiple threads, I have no clue what is the Time Complexity
+	 * @brief Heart of approximate string matching, a task of the pool
+	 * @param[in,out] search Word to find match, current cutoff and matches found
+	 * @param[in] pref Preffix of the words below node
+	 * @param[in] column Edit distances between pref and every prefix of the word, the last column of the DP table of the parent
+	 * @param[in] node Node to explore
+	 * @param[in] worker Worker of the pool running the task
+	 * @detail Extends the column over the characters of node and spawns a task per child, unless every entry of the column is
+	 * at the cutoff or above: entries never decrease further down, so no word below can be closer.
+	 * Time Complexity O(l*m/64), for l characters in the node and m the word length, Space Complexity O(m/64)
 	 */
-	void static suffixDFS(const std::string &word, const std::string pref , node_t chr, unsigned int *min_dist, std::list<std::string> *results);
+	void suffixDFS(FuzzySearch &search, const std::string pref, MyersPattern::Column column, uint32_t node, unsigned int worker) const;
 
 /**********************************************************************************************************
 **************************************** UTILITIES ********************************************************
 **********************************************************************************************************/
 
 	/**
-	 * @brief Checks the character exists in the next level of the trie
-	 * @param[in] chr Character to check the existance
-	 * @param[in] arr Base node
-	 * @return Position in the array where the character occurs, or -1 if it does not occur
+	 * @brief Child of a node starting with a character
+	 * @param[in] node Base node
+	 * @param[in] chr Character to look for
+	 * @return The child, or NO_NODE if there is none
+	 * @detail Time Complexity O(1), Space Complexity O(1)
 	 */
-	int charExistsInArr(const char &chr, const node_t *arr) const;
+	uint32_t childOf(uint32_t node, char chr) const;
 
 	/**
-	 * @brief Converts from ASCII notation to array position
-	 * @param[in] chr Char to convert
-	 * @return The array position of the character
-	 * @detail Time Complexity O(1), Space Complexity O(1)
+	 * @brief Characters of a node
 	 */
-	unsigned char charToArrPos(char chr) const;
+	inline std::string label(uint32_t node) const { return this->labels.substr(this->nodes[node].label_offset, this->nodes[node].label_size); }
 
 	/**
-	 * @brief Used to print a given array (purely for debugging purposes)
-	 * @param[in] arr Array to be printed
+	 * @brief Converts from ASCII notation to array position
+	 * @param[in] chr Char to convert
+	 * @return The array position of the character, -1 if it is not a letter, a number or a space
+	 * @detail Time Complexity O(1), Space Complexity O(1)
 	 */
-	void printArr(const node_t *arr) const;
+	int charToArrPos(char chr) const;
 };
 
 
@@ -7,12 +7,22 @@
 
 using namespace std;
 
+static RoutingAlgorithm routing_algorithm = ASTAR;
+static const char * routing_names[] = {"A*", "Contraction Hierarchies", "ALT", "Bidirectional A*", "One to many", "Dynamic shortest path tree", "Traffic assignment"};
+const unsigned int N_ROUTING_ALGORITHMS = 7;
+const unsigned int SIMILAR_NAMES = 5;
+const unsigned int SIMILAR_NAMES_MAX_DISTANCE = 4;
+
 
 template<class T>
 void  carsMovingMenu( Graph<T> &graph , Vertex<T> *sourc , GraphViewer *gv, unsigned long int &n_nodes){
 	bool run_all = false;
 	char chr;
+	std::chrono::high_resolution_clock::time_point current = std::chrono::high_resolution_clock::now();
+	graph.planRoutes(routing_algorithm,sourc,n_nodes);
+	cout << "	" << routing_names[routing_algorithm] << " planned " << graph.getCarsDest().size() << " routes in " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - current).count() << "s using " << graph.getNumWorkers() << " threads\n";
 	cout << "Generating alternatives at character inserted \n";
+	unsigned int car = 0;
 	for (Vertex<T> *dest : graph.getCarsDest() ){
 		cout << "Generating for " << sourc->getIDMask() << " -> " << dest->getIDMask();
 		if(!run_all){
@@ -22,12 +32,13 @@ void  carsMovingMenu( Graph<T> &graph , Vertex<T> *sourc , GraphViewer *gv, unsi
 				run_all = true;
 		}
 
-		std::chrono::high_resolution_clock::time_point current = std::chrono::high_resolution_clock::now();
-		graph.Astar(sourc,dest,n_nodes);
-		cout << "	A* took " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - current).count() << "s \n";
-		if (dest->path != NULL){
+		current = std::chrono::high_resolution_clock::now();
+		const Route &route = graph.commitRoute(car++,routing_algorithm,sourc,n_nodes);
+		cout << "	" << routing_names[routing_algorithm] << " explored " << route.explored << " nodes\n";
+		cout << "	Commit took " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - current).count() << "s \n";
+		if (route.found()){
+			cout << "	!SUCESS!	\n";
 			dest->setResolved(true);
-			graph.updatePath(dest);
 		}
 		else{
 			dest->setReachable(false);
@@ -37,12 +48,33 @@ void  carsMovingMenu( Graph<T> &graph , Vertex<T> *sourc , GraphViewer *gv, unsi
 	}
 }
 
+template<class T>
+void routingMenu(Graph<T> &graph){
+	cout << "Routing algorithm (current: " << routing_names[routing_algorithm] << ")" << endl;
+	for (unsigned int i = 0; i < N_ROUTING_ALGORITHMS; i++)
+		cout << "  " << i+1 << ". " << routing_names[i] << endl;
+	uint16 option = getInput();
+	cout << endl;
+	if (option < 1 || option > N_ROUTING_ALGORITHMS)
+		return;
+	routing_algorithm = (RoutingAlgorithm) (option-1);
+	std::chrono::high_resolution_clock::time_point current = std::chrono::high_resolution_clock::now();
+	if (routing_algorithm == CONTRACTION_HIERARCHIES && !graph.hasContractionHierarchy())
+		graph.buildContractionHierarchy();
+	else if (routing_algorithm == ALT && !graph.hasLandmarks())
+		graph.buildLandmarks();
+	else
+		return;
+	cout << "   Preprocessing Time: " << std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - current).count() << "s\n";
+}
+
 template<class T>
 bool menu(Graph<T> &graph, GraphViewer *gv){
 	unsigned long int n_nodes = 0;
 	cout << "Menu" << endl
 		 << "  1. Cut road" << endl
 		 << "  2. Reset" << endl
+		 << "  3. Routing algorithm" << endl
 		 << "  0. Exit" << endl;
 		uint16 option = getInput();
 		cout << endl;
@@ -56,22 +88,21 @@ bool menu(Graph<T> &graph, GraphViewer *gv){
 					carsMovingMenu(graph,v,gv,n_nodes);
 				}
 			} else {
-				list<string>* similarNames = graph.approximateWordSearch(streetName);
-				auto it = similarNames->begin();
-				auto ite = similarNames->end();
-				if(it != ite){
+				vector<fuzzy_match_t> similarNames = graph.approximateWordSearch(streetName, SIMILAR_NAMES_MAX_DISTANCE, SIMILAR_NAMES);
+				if(!similarNames.empty()){
 					cout << "Street name not found. Did you mean any of these streets?\n";
-					while(it != ite){
-						cout << "    " << *it << endl;
-						it++;
-					}
+					for(const fuzzy_match_t &match : similarNames)
+						cout << "    " << match.word << endl;
 				} else
-					cout << "Street name found. No similar names found.\n";
+					cout << "Street name not found. No similar names found.\n";
 			}
 			return true;
 		} else if(option == 2) {
 			graph.resetGraph();
 			return true;
+		} else if(option == 3) {
+			routingMenu(graph);
+			return true;
 		}
 
 		return false;
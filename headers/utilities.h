@@ -2,11 +2,13 @@
 #define UTILITIES_H
 
 #include "graph.h"
+#include "text_parser.h"
 #include <fstream>
 #include <algorithm>
 #include <sstream>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <cmath>
 
 #define NODES_FILE "rsc/Nodes5.txt"
@@ -18,13 +20,11 @@ using namespace std;
 typedef unsigned int uint16;
 typedef long long int int64;
 
-unsigned int numberOfLines(const char * file_name);
 string nextStreetName();
 string getStreetName();
 uint16 getInput();
 void printSquareArray(int ** arr, unsigned int size);
 
-static map<long long int, unsigned long int> node_big_to_small;
 static bool init = false;
 static double minLatitute;
 static double maxLatitude;
@@ -73,124 +73,129 @@ void updateBounds(const Vertex<T> *v) {
 
 template<class T>
 void loadNodes(Graph<T> &graph) {
-	//Format: nodeID;latitudeDegrees;longitudeDegrees;longitudeRadians;latitudeRadians
-	string line, file_name = NODES_FILE;
-	ifstream file;
-	file.open(file_name);
-	if (!file.is_open()) {
-		cout << "Failed to open Node txt file!\n";
+	vector<NodeRecord> nodes;
+	if (!parseNodes(NODES_FILE, graph.getPool(), nodes)) {
+		cout << "Failed to read Node txt file!\n";
 		exit(1);
 	}
-	unsigned int n_lines = numberOfLines( file_name.c_str() );
-	graph.initializeSet(n_lines+1);
-	while (getline(file, line)) {
-		T nodeID;
-		double latitudeDegrees, longitudeDegrees;
-		double longitudeRadians, latitudeRadians;
-		char delimiter;
-		istringstream iss(line);
-		iss >> nodeID >> delimiter >> latitudeDegrees >> delimiter
-				>> longitudeDegrees >> delimiter >> longitudeRadians
-				>> delimiter >> latitudeRadians;
-		Vertex<T> *v = new Vertex<T>(nodeID, latitudeRadians, longitudeRadians);
+	graph.initializeSet(nodes.size()+1);
+	for (const NodeRecord &node : nodes) {
+		Vertex<T> *v = graph.createVertex(node.id, node.latitude, node.longitude);
 		updateBounds(v);
 		graph.addVertex(v);
-		node_big_to_small.insert( pair<long long int , unsigned long int>(nodeID , graph.getCounter()-1) );
 	}
-	file.close();
+	graph.indexVertexIDs();
 }
 
+/**
+ * Edges of the graph with the same edgeID (from the files) and their origin, in the order they were loaded
+ */
+template<class T>
+using EdgeIndex = unordered_map<T, vector< pair<Vertex<T>*, Edge<T>*> > >;
+
 template<class T>
-void loadEdges(Graph<T> &graph) {
-	//Format: edgeID;node1ID;node2ID;
-	string line;
-	ifstream file;
-	file.open(EDGES_FILE);
-	if (!file.is_open()) {
-		cout << "Failed to open Edges txt file!\n";
+void loadEdges(Graph<T> &graph, EdgeIndex<T> &edgeIndex) {
+	vector<EdgeRecord> edges;
+	if (!parseEdges(EDGES_FILE, graph.getPool(), edges)) {
+		cout << "Failed to read Edges txt file!\n";
 		exit(1);
 	}
-	while (getline(file, line)) {
-		T edgeID, srcID, dstID;
-		char delimiter;
-		istringstream iss(line);
-		iss >> edgeID >> delimiter >> srcID >> delimiter >> dstID;
-		Vertex<T>* src = graph.getVertexByIDMask( node_big_to_small[srcID] );
-		Vertex<T>* dst = graph.getVertexByIDMask( node_big_to_small[dstID] );
-		if (src != nullptr && dst != nullptr)
-			src->addEdge( new Edge<T>(dst, edgeID, calculateDistance(src, dst)) );
+	vector<T> endpointIDs;
+	endpointIDs.reserve(2 * edges.size());
+	for (const EdgeRecord &record : edges) {
+		endpointIDs.push_back(record.sourc);
+		endpointIDs.push_back(record.dest);
+	}
+	vector<Vertex<T>*> endpoints;
+	graph.getVertexesByID(endpointIDs, endpoints);
+
+	vector<Vertex<T>*> sources, destinations;
+	vector<T> edgeIDs;
+	UnitVectorArray sourcePositions, destinationPositions;
+	for (unsigned int i = 0; i < edges.size(); i++) {
+		Vertex<T>* src = endpoints[2 * i];
+		Vertex<T>* dst = endpoints[2 * i + 1];
+		if (src != nullptr && dst != nullptr) { //edges to nodes not in the Nodes file are dropped
+			sources.push_back(src);
+			destinations.push_back(dst);
+			edgeIDs.push_back(edges[i].id);
+			sourcePositions.push_back(src->getPosition());
+			destinationPositions.push_back(dst->getPosition());
+		}
+	}
+
+	//Every weight in one pass
+	vector<int> weights;
+	batchGreatCircleDistance(sourcePositions, destinationPositions, weights);
+	edgeIndex.clear();
+	edgeIndex.reserve(sources.size());
+	for (unsigned int i = 0; i < sources.size(); i++) {
+		if (sources[i]->getAdjacent().count(destinations[i]->getIDMask()) != 0)
+			continue; //there already is an edge between the two vertexes
+		Edge<T> *edge = graph.createEdge(destinations[i], edgeIDs[i], weights[i]);
+		sources[i]->addEdge(edge);
+		edgeIndex[edgeIDs[i]].push_back( make_pair(sources[i], edge) );
 	}
-	file.close();
 }
 
 template<class T>
-void loadStreets(Graph<T> &graph) {
-	node_big_to_small.clear();
-	//Format: edgeID;streetName;isTwoWays;
-	string line;
-	ifstream file;
-	file.open(STREETS_FILE);
-	if (!file.is_open()) {
-		cout << "Failed to open Streets txt file!\n";
+void loadStreets(Graph<T> &graph, const EdgeIndex<T> &edgeIndex) {
+	vector<StreetRecord> streets;
+	if (!parseStreets(STREETS_FILE, graph.getPool(), streets)) {
+		cout << "Failed to read Streets txt file!\n";
 		exit(1);
 	}
-	while (getline(file, line)) {
-		T edgeID;
-		string streetName, isTwoWaysStr;
-		bool isTwoWays;
-		char delimiter;
-		string isTwoWayStr;
-		istringstream iss(line);
-		iss >> edgeID >> delimiter;
-		getline(iss, streetName, delimiter);
-		iss >> delimiter;
-		getline(iss, isTwoWaysStr, '\n');
-		isTwoWays = (delimiter == 'T');
-
+	for (const StreetRecord &street : streets) {
+		const string &streetName = street.name;
+		bool isTwoWays = street.two_ways;
+		auto it = edgeIndex.find(street.id);
+		if (it == edgeIndex.end())
+			continue;
 		int i = 0;
-		for (Vertex<T> * vertex : graph.getVertexSet() ){
-			for( pair<long long int , Edge<T> *> p : vertex->getAdjacent() ){
-				if (p.second->getID() == edgeID){
-					i++;
-					Edge<T> *ed = p.second;
-					ed->setName(streetName + to_string(i));
-					ed->setTwoWays(isTwoWays);
-					ed->setSourc(vertex);
-					string triename = streetName + to_string(i);
-					transform(triename.begin(), triename.end(), triename.begin(), ::toupper);
-					graph.insertNameToEdge(triename, ed);
-					graph.insertWordToTrie(triename);
-					if (isTwoWays) {
-						Edge<T>* oppositeEdge = new Edge<T>(vertex, (-1 * ed->getID()), calculateDistance(vertex, ed->getDest()));
-						oppositeEdge->setSourc( ed->getDest() );
-						oppositeEdge->setName(streetName + to_string(i)+"B");
-						ed->getDest()->addEdge(oppositeEdge);
-						triename += "B";
-						graph.insertNameToEdge(triename, oppositeEdge);
-						graph.insertWordToTrie(triename);
-					}
-				}
+		for (const pair<Vertex<T>*, Edge<T>*> &p : it->second) {
+			i++;
+			Vertex<T> *vertex = p.first;
+			Edge<T> *ed = p.second;
+			ed->setName(streetName + to_string(i));
+			ed->setTwoWays(isTwoWays);
+			ed->setSourc(vertex);
+			string triename = streetName + to_string(i);
+			transform(triename.begin(), triename.end(), triename.begin(), ::toupper);
+			graph.insertNameToEdge(triename, ed);
+			graph.insertWordToTrie(triename);
+			if (isTwoWays) {
+				Edge<T>* oppositeEdge = graph.createEdge(vertex, (-1 * ed->getID()), ed->getWeight()); //same length both ways
+				oppositeEdge->setSourc( ed->getDest() );
+				oppositeEdge->setName(streetName + to_string(i)+"B");
+				ed->getDest()->addEdge(oppositeEdge);
+				triename += "B";
+				graph.insertNameToEdge(triename, oppositeEdge);
+				graph.insertWordToTrie(triename);
 			}
 		}
 	}
-	file.close();
+}
+
+/**
+ * Loads the whole map: nodes, then edges (indexing them by edgeID), then the streets through that index,
+ * and builds the street name trie and the CSR snapshot. Every file is read once, so loading is linear in their size.
+ */
+template<class T>
+void loadGraph(Graph<T> &graph) {
+	EdgeIndex<T> edgeIndex;
+	loadNodes(graph);
+	loadEdges(graph, edgeIndex);
+	loadStreets(graph, edgeIndex);
+	graph.buildTrie();
+	graph.buildCSR();
 }
 
 /*!
- *	Calculates the distance between two points on earth (in m) using Haversine's formula
+ *	Calculates the distance between two points on earth (in m) from their precomputed unit vectors (see greatCircleDistance)
  */
 template<class T>
 int calculateDistance(Vertex<T> *v1, Vertex<T> *v2) {
-	double earthRadius = 6371;
-	double deltaLatitude = v2->getLatitude() - v1->getLatitude();
-	double deltaLongitude = v2->getLongitude() - v1->getLongitude();
-
-	double a = sin(deltaLatitude / 2) * sin(deltaLatitude / 2)
-			+ cos(v1->getLatitude()) * cos(v2->getLatitude())
-					* sin(deltaLongitude / 2) * sin(deltaLongitude / 2);
-	double b = 2 * atan2(sqrt(a), sqrt(1 - a));
-	double c = earthRadius * b;
-	return abs(c*1000);
+	return greatCircleDistance(v1->getPosition(), v2->getPosition());
 }
 
 
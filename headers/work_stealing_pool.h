@@ -0,0 +1,88 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+	@brief Fixed set of threads that run a tree of tasks, where tasks spawn more tasks
+	@detail Each worker keeps its own deque: it pushes its tasks at the back and runs them from the front, so the tree
+	is explored level by level, the order the thread per task it replaces ran in. When it runs out it steals the newest
+	task at the back of another worker's deque, so owner and thief work at opposite ends.
+	The calling thread works too, as worker 0, so a pool of size 1 has no threads at all and runs everything inline.
+	Only one tree runs at a time, concurrent calls to run wait for their turn.
+	@var workers Background threads (workers 1 to size()-1)
+	@var queues Deque of tasks of each worker
+	@var pending Tasks spawned and not finished yet, the tree is done when it reaches 0
+	@var running Serializes the calls to run
+	@var busy Background workers still inside the current tree
+	@var generation Number of trees started, used to wake the workers
+	@var stopping Set by the destructor to end the workers
+*/
+class WorkStealingPool {
+public:
+	typedef std::function<void(unsigned int)> Task;
+
+private:
+	struct Queue {
+		std::mutex lock;
+		std::deque<Task> tasks;
+	};
+	std::vector<std::thread> workers;
+	std::vector< std::unique_ptr<Queue> > queues;
+	std::atomic<unsigned long int> pending;
+	std::mutex running;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	unsigned int busy = 0;
+	unsigned long int generation = 0;
+	bool stopping = false;
+
+public:
+	/**
+	 * @brief Starts the background workers
+	 * @param[in] n_threads Total number of workers, counting the calling thread (0 means one per core)
+	 */
+	WorkStealingPool(unsigned int n_threads = 0);
+
+	/**
+	 * @brief Stops and joins the background workers
+	 */
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool &) = delete;
+	WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+	/**
+	 * @brief Number of workers, counting the calling thread
+	 */
+	inline unsigned int size() const { return this->workers.size() + 1; }
+
+	/**
+	 * @brief Runs a task and every task spawned from it, and waits for all of them
+	 * @param[in] root First task, called with the worker running it
+	 */
+	void run(const Task &root);
+
+	/**
+	 * @brief Adds a task to the tree being run, must be called from one of its tasks
+	 * @param[in] worker Worker running the calling task
+	 * @param[in] task Task to add
+	 */
+	void spawn(unsigned int worker, Task task);
+
+private:
+	bool pop(unsigned int worker, Task &task);
+	bool steal(unsigned int worker, Task &task);
+	void work(unsigned int worker);
+	void workerLoop(unsigned int worker);
+};
+
+#endif /* WORK_STEALING_POOL_H */
@@ -0,0 +1,67 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+	@brief Fixed set of threads that run the iterations of a loop in parallel
+	@detail Iterations are handed out through an atomic counter. The calling thread works too, as worker 0,
+	so a pool of size 1 has no threads at all and runs everything inline.
+	@var workers Background threads (workers 1 to size()-1)
+	@var job Body of the loop being run, called with (iteration, worker)
+	@var job_size Number of iterations of the loop being run
+	@var next Next iteration to hand out
+	@var busy Background workers still inside the current loop
+	@var generation Number of loops started, used to wake the workers
+	@var stopping Set by the destructor to end the workers
+*/
+class WorkerPool {
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const std::function<void(unsigned int, unsigned int)> *job = nullptr;
+	unsigned int job_size = 0;
+	std::atomic<unsigned int> next;
+	unsigned int busy = 0;
+	unsigned long int generation = 0;
+	bool stopping = false;
+
+public:
+	/**
+	 * @brief Starts the background workers
+	 * @param[in] n_threads Total number of workers, counting the calling thread (0 means one per core)
+	 */
+	WorkerPool(unsigned int n_threads = 0);
+
+	/**
+	 * @brief Stops and joins the background workers
+	 */
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	/**
+	 * @brief Number of workers, counting the calling thread
+	 */
+	inline unsigned int size() const { return this->workers.size() + 1; }
+
+	/**
+	 * @brief Runs body(i, worker) for every i in [0, count) and waits for all of them
+	 * @param[in] count Number of iterations
+	 * @param[in] body Loop body, worker is in [0, size()) and is never used by two threads at once
+	 */
+	void parallelFor(unsigned int count, const std::function<void(unsigned int, unsigned int)> &body);
+
+private:
+	void run(unsigned int worker);
+	void workerLoop(unsigned int worker);
+};
+
+#endif /* WORKER_POOL_H */
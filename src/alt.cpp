@@ -0,0 +1,168 @@
+#include "../headers/alt.h"
+#include "../headers/indexed_heap.h"
+
+#include <cstdlib>
+
+using namespace std;
+
+/**
+ * @brief Dijkstra over every edge (cut and full roads included)
+ * @param[in] graph Graph to search
+ * @param[in] sourc Start vertex
+ * @param[in] reverse Whether to follow the edges backwards (distances to sourc instead of from it)
+ * @param[out] dist Distance of each vertex (INT_MAX if unreachable)
+ * @param[out] parent Parent of each vertex in the shortest path tree
+ * @param[out] order Vertexes in the order they were settled
+ * @detail Time Complexity O((V+E)*log(V)), Space Complexity O(V)
+ */
+static void fullDijkstra(const CSRGraph &graph, unsigned int sourc, bool reverse,
+		vector<int> &dist, vector<unsigned int> &parent, vector<unsigned int> &order) {
+	unsigned int n = graph.getNumVertex();
+	IndexedHeap<int> open_list(n);
+	dist.assign(n, INT_MAX);
+	parent.assign(n, UINT_MAX);
+	order.clear();
+	dist[sourc] = 0;
+	open_list.push(sourc, 0);
+	while (!open_list.empty()) {
+		unsigned int u = open_list.pop();
+		order.push_back(u);
+		unsigned int begin = reverse ? graph.reverseBegin(u) : graph.edgesBegin(u);
+		unsigned int end = reverse ? graph.reverseEnd(u) : graph.edgesEnd(u);
+		for (unsigned int i = begin; i < end; i++) {
+			unsigned int v = reverse ? graph.getReverseSource(i) : graph.getTarget(i);
+			int d = dist[u] + graph.getWeight(reverse ? graph.getReverseEdge(i) : i);
+			if (d < dist[v]) {
+				dist[v] = d;
+				parent[v] = u;
+				open_list.pushOrDecrease(v, d);
+			}
+		}
+	}
+}
+
+void Landmarks::build(const CSRGraph &graph, unsigned int count, Strategy strategy) {
+	unsigned int n = graph.getNumVertex();
+	this->landmarks.clear();
+	this->stride = count;
+	this->from.assign((size_t) n * count, INT_MAX);
+	this->to.assign((size_t) n * count, INT_MAX);
+	if (n == 0)
+		return;
+
+	vector<int> dist;
+	vector<unsigned int> parent, order;
+	unsigned int start = rand() % n;
+	for (unsigned int i = 0; i < count; i++) {
+		unsigned int landmark = start;
+		if (strategy == AVOID)
+			landmark = this->avoidLandmark(graph, (i == 0) ? start : rand() % n);
+		else if (i == 0) { //farthest vertex from a random one
+			fullDijkstra(graph, start, false, dist, parent, order);
+			landmark = order.back();
+		} else { //vertex whose closest landmark is the farthest, vertexes not covered at all come first
+			long long best = -1;
+			for (unsigned int v = 0; v < n; v++) {
+				long long closest = LLONG_MAX;
+				for (unsigned int l = 0; l < i; l++) {
+					size_t pos = (size_t) v * this->stride + l;
+					if (this->from[pos] != INT_MAX && this->to[pos] != INT_MAX)
+						closest = min(closest, (long long) this->from[pos] + this->to[pos]);
+				}
+				if (closest > best) {
+					best = closest;
+					landmark = v;
+				}
+			}
+		}
+
+		bool repeated = false;
+		for (unsigned int l : this->landmarks)
+			repeated = repeated || (l == landmark);
+		if (repeated)
+			continue;
+		this->landmarks.push_back(landmark);
+		this->computeTables(graph, this->landmarks.size() - 1);
+	}
+}
+
+void Landmarks::computeTables(const CSRGraph &graph, unsigned int pos) {
+	vector<int> dist;
+	vector<unsigned int> parent, order;
+	unsigned int n = graph.getNumVertex();
+	fullDijkstra(graph, this->landmarks[pos], false, dist, parent, order);
+	for (unsigned int v = 0; v < n; v++)
+		this->from[(size_t) v * this->stride + pos] = dist[v];
+	fullDijkstra(graph, this->landmarks[pos], true, dist, parent, order);
+	for (unsigned int v = 0; v < n; v++)
+		this->to[(size_t) v * this->stride + pos] = dist[v];
+}
+
+unsigned int Landmarks::avoidLandmark(const CSRGraph &graph, unsigned int root) const {
+	unsigned int n = graph.getNumVertex();
+	vector<int> dist;
+	vector<unsigned int> parent, order;
+	fullDijkstra(graph, root, false, dist, parent, order);
+
+	//Size of a subtree is how badly the current landmarks bound it, 0 if it already holds a landmark
+	vector<long long> size(n, 0);
+	vector<char> covered(n, false);
+	for (unsigned int l : this->landmarks)
+		covered[l] = true;
+	for (auto it = order.rbegin(); it != order.rend(); it++) {
+		unsigned int v = *it;
+		int bound = this->landmarks.empty() ? 0 : this->lowerBound(root, v);
+		if (!covered[v])
+			size[v] += dist[v] - ((bound == INT_MAX) ? 0 : bound);
+		else
+			size[v] = 0;
+		if (v != root) {
+			covered[parent[v]] = covered[parent[v]] || covered[v];
+			size[parent[v]] += size[v];
+		}
+	}
+
+	//Children of each vertex in the tree
+	vector<unsigned int> child_offsets(n + 1, 0), children(order.size());
+	for (unsigned int v : order)
+		if (v != root)
+			child_offsets[parent[v] + 1]++;
+	for (unsigned int v = 0; v < n; v++)
+		child_offsets[v + 1] += child_offsets[v];
+	vector<unsigned int> fill(child_offsets.begin(), child_offsets.end() - 1);
+	for (unsigned int v : order)
+		if (v != root)
+			children[fill[parent[v]]++] = v;
+
+	//Walk down the heaviest subtree until a leaf
+	unsigned int v = root;
+	while (child_offsets[v] != child_offsets[v + 1]) {
+		unsigned int heaviest = children[child_offsets[v]];
+		for (unsigned int c = child_offsets[v]; c < child_offsets[v + 1]; c++)
+			if (size[children[c]] > size[heaviest])
+				heaviest = children[c];
+		v = heaviest;
+	}
+	return v;
+}
+
+int Landmarks::lowerBound(unsigned int sourc, unsigned int dest) const {
+	const int *s_from = &this->from[(size_t) sourc * this->stride], *t_from = &this->from[(size_t) dest * this->stride];
+	const int *s_to = &this->to[(size_t) sourc * this->stride], *t_to = &this->to[(size_t) dest * this->stride];
+	int best = 0;
+	for (unsigned int l = 0; l < this->landmarks.size(); l++) {
+		//d(s,t) >= d(L,t) - d(L,s)
+		if (s_from[l] != INT_MAX) {
+			if (t_from[l] == INT_MAX) //L reaches s but not t, so s does not reach t
+				return INT_MAX;
+			best = max(best, t_from[l] - s_from[l]);
+		}
+		//d(s,t) >= d(s,L) - d(t,L)
+		if (t_to[l] != INT_MAX) {
+			if (s_to[l] == INT_MAX) //t reaches L but s does not, so s does not reach t
+				return INT_MAX;
+			best = max(best, s_to[l] - t_to[l]);
+		}
+	}
+	return best;
+}
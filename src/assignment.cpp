@@ -0,0 +1,201 @@
+#include "../headers/assignment.h"
+
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Roads are handed to the workers in blocks of this size by the per road loops
+ */
+static const unsigned int EDGE_BLOCK = 4096;
+
+TrafficAssignment::Stats TrafficAssignment::assign(const CSRGraph &graph, const vector<unsigned int> &capacity,
+		const vector< pair<unsigned int, unsigned int> > &trips, WorkerPool &pool,
+		vector<Route> &routes, unsigned int max_iterations, double tolerance) {
+	unsigned int n = graph.getNumVertex(), m = graph.getNumEdges();
+	unsigned int n_blocks = (m + EDGE_BLOCK - 1) / EDGE_BLOCK;
+	Stats stats;
+	this->capacity = capacity;
+	this->flow.assign(m, 0);
+	this->cost.assign(m, 0);
+	this->workspaces.resize(pool.size());
+	for (Workspace &ws : this->workspaces) {
+		ws.dist.assign(n, INFINITY);
+		ws.parent.assign(n, NO_EDGE);
+		ws.parent_edge.assign(n, NO_EDGE);
+		ws.demand.assign(n, 0);
+		ws.open_list.resize(n);
+	}
+
+	//Group the cars by origin, each origin is one tree per iteration
+	vector<unsigned int> by_origin(trips.size());
+	for (unsigned int i = 0; i < trips.size(); i++)
+		by_origin[i] = i;
+	stable_sort(by_origin.begin(), by_origin.end(), [&trips] (unsigned int a, unsigned int b) {
+		return trips[a].first < trips[b].first;
+	});
+	vector<unsigned int> origin_begin;
+	for (unsigned int i = 0; i < by_origin.size(); i++)
+		if (i == 0 || trips[by_origin[i]].first != trips[by_origin[i - 1]].first)
+			origin_begin.push_back(i);
+	origin_begin.push_back(by_origin.size());
+	unsigned int n_origins = origin_begin.size() - 1;
+
+	vector<double> sp_cost(pool.size());
+	auto all_or_nothing = [&] (unsigned int group, unsigned int worker) {
+		Workspace &ws = this->workspaces[worker];
+		unsigned int origin = trips[by_origin[origin_begin[group]]].first, targets = 0;
+		for (unsigned int i = origin_begin[group]; i < origin_begin[group + 1]; i++) {
+			unsigned int dest = trips[by_origin[i]].second;
+			if (ws.demand[dest] == 0)
+				targets++;
+			ws.demand[dest]++;
+		}
+		this->shortestPathTree(graph, origin, targets, nullptr, ws);
+		//Push the demand of every vertex up the tree, children are settled after their parents
+		for (auto it = ws.order.rbegin(); it != ws.order.rend(); it++) {
+			unsigned int v = *it;
+			if (ws.demand[v] == 0 || v == origin)
+				continue;
+			sp_cost[worker] += ws.demand[v] * this->cost[ws.parent_edge[v]];
+			ws.load[ws.parent_edge[v]] += ws.demand[v];
+			ws.demand[ws.parent[v]] += ws.demand[v];
+			ws.demand[v] = 0;
+		}
+		//Cars whose destination was not reached
+		for (unsigned int i = origin_begin[group]; i < origin_begin[group + 1]; i++)
+			ws.demand[trips[by_origin[i]].second] = 0;
+		ws.demand[origin] = 0;
+	};
+
+	vector<double> block_total(n_blocks);
+	for (unsigned int k = 1; k <= max_iterations; k++) {
+		pool.parallelFor(n_blocks, [this, &graph, m] (unsigned int block, unsigned int) {
+			this->updateCosts(graph, block * EDGE_BLOCK, min(m, (block + 1) * EDGE_BLOCK));
+		});
+		for (Workspace &ws : this->workspaces)
+			ws.load.assign(m, 0);
+		sp_cost.assign(pool.size(), 0);
+		pool.parallelFor(n_origins, all_or_nothing);
+
+		//Average the new loads into the flows: x = x + (y - x) / k
+		double step = 1.0 / k;
+		pool.parallelFor(n_blocks, [this, m, step, &block_total] (unsigned int block, unsigned int) {
+			double total = 0;
+			for (unsigned int e = block * EDGE_BLOCK; e < min(m, (block + 1) * EDGE_BLOCK); e++) {
+				double load = 0;
+				for (const Workspace &ws : this->workspaces)
+					load += ws.load[e];
+				total += this->flow[e] * this->cost[e];
+				this->flow[e] += (load - this->flow[e]) * step;
+			}
+			block_total[block] = total;
+		});
+		stats.iterations = k;
+		if (k == 1)
+			continue; //there were no flows to compare with yet
+		double total = 0, shortest = 0;
+		for (double t : block_total)
+			total += t;
+		for (double c : sp_cost)
+			shortest += c;
+		stats.relative_gap = (total > 0) ? (total - shortest) / total : 0;
+		if (stats.relative_gap < tolerance)
+			break;
+	}
+
+	pool.parallelFor(n_blocks, [this, &graph, m] (unsigned int block, unsigned int) {
+		this->updateCosts(graph, block * EDGE_BLOCK, min(m, (block + 1) * EDGE_BLOCK));
+	});
+	for (unsigned int e = 0; e < m; e++)
+		stats.total_cost += this->flow[e] * this->cost[e];
+
+	//Give each car, in order, its shortest path on the converged costs that still has room for it
+	Workspace &ws = this->workspaces[0];
+	vector<unsigned int> &room = this->capacity;
+	unsigned int tree_origin = NO_EDGE;
+	routes.assign(trips.size(), Route());
+	for (unsigned int i = 0; i < trips.size(); i++) {
+		unsigned int origin = trips[i].first, dest = trips[i].second;
+		Route &route = routes[i];
+		for (int attempt = 0; attempt < 2; attempt++) {
+			if (tree_origin != origin || attempt > 0) {
+				tree_origin = origin;
+				this->shortestPathTree(graph, origin, 0, &room, ws);
+				route.explored = ws.order.size();
+				stats.trees++;
+			}
+			route.edges.clear();
+			route.dist = INT_MAX;
+			if (origin != dest && ws.parent_edge[dest] == NO_EDGE)
+				break;
+			bool full = false;
+			route.dist = 0;
+			for (unsigned int v = dest; v != origin; v = ws.parent[v]) {
+				unsigned int e = ws.parent_edge[v];
+				full = full || room[e] == 0;
+				route.edges.push_back(e);
+				route.dist += graph.getWeight(e);
+			}
+			if (!full)
+				break;
+		}
+		if (!route.found()) {
+			stats.unreachable++;
+			continue;
+		}
+		reverse(route.edges.begin(), route.edges.end());
+		for (unsigned int e : route.edges)
+			room[e]--;
+	}
+	return stats;
+}
+
+void TrafficAssignment::updateCosts(const CSRGraph &graph, unsigned int begin, unsigned int end) {
+	for (unsigned int e = begin; e < end; e++) {
+		double free_flow = graph.getWeight(e);
+		double ratio = (this->capacity[e] > 0) ? this->flow[e] / this->capacity[e] : 0;
+		this->cost[e] = free_flow * (1 + BPR_ALPHA * pow(ratio, BPR_BETA));
+	}
+}
+
+void TrafficAssignment::shortestPathTree(const CSRGraph &graph, unsigned int origin, unsigned int targets,
+		const vector<unsigned int> *full, Workspace &ws) const {
+	for (unsigned int v : ws.touched) {
+		ws.dist[v] = INFINITY;
+		ws.parent[v] = NO_EDGE;
+		ws.parent_edge[v] = NO_EDGE;
+	}
+	ws.touched.clear();
+	ws.order.clear();
+	ws.open_list.clear();
+	ws.dist[origin] = 0;
+	ws.touched.push_back(origin);
+	ws.open_list.push(origin, 0);
+	bool all = (targets == 0);
+	if (!all && ws.demand[origin] > 0)
+		targets--;
+
+	while (!ws.open_list.empty() && (all || targets > 0)) {
+		unsigned int u = ws.open_list.pop();
+		ws.order.push_back(u);
+		for (unsigned int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+			if (graph.isBlocked(e) || (full != nullptr && (*full)[e] == 0))
+				continue;
+			unsigned int v = graph.getTarget(e);
+			double d = ws.dist[u] + this->cost[e];
+			if (d < ws.dist[v]) {
+				if (ws.dist[v] == INFINITY)
+					ws.touched.push_back(v);
+				ws.dist[v] = d;
+				ws.parent[v] = u;
+				ws.parent_edge[v] = e;
+				ws.open_list.pushOrDecrease(v, d);
+			}
+		}
+		if (!all && ws.demand[u] > 0 && u != origin)
+			targets--;
+	}
+}
@@ -0,0 +1,296 @@
+#include "../headers/ch.h"
+
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+using namespace std;
+
+/**
+ * @brief Adds two lengths, INT_MAX standing for infinity
+ */
+static inline int addLength(int a, int b) {
+	if (a == INT_MAX || b == INT_MAX)
+		return INT_MAX;
+	long long sum = (long long) a + b;
+	return (sum >= INT_MAX) ? INT_MAX : (int) sum;
+}
+
+/**
+ * @brief Length of a CSR edge, INT_MAX if there is no edge or it is cut or full
+ */
+static inline int edgeLength(const CSRGraph &graph, unsigned int edge) {
+	if (edge == NO_EDGE || graph.isBlocked(edge))
+		return INT_MAX;
+	return graph.getWeight(edge);
+}
+
+void ContractionHierarchy::build(const CSRGraph &graph) {
+	unsigned int n = graph.getNumVertex();
+	vector< vector<unsigned int> > nbrs(n), up(n);
+	for (unsigned int v = 0; v < n; v++)
+		for (unsigned int e = graph.edgesBegin(v); e < graph.edgesEnd(v); e++)
+			if (graph.getTarget(e) != v) {
+				nbrs[v].push_back(graph.getTarget(e));
+				nbrs[graph.getTarget(e)].push_back(v);
+			}
+
+	IndexedHeap<unsigned int> heap(n);
+	for (unsigned int v = 0; v < n; v++) {
+		sort(nbrs[v].begin(), nbrs[v].end());
+		nbrs[v].erase(unique(nbrs[v].begin(), nbrs[v].end()), nbrs[v].end());
+		heap.push(v, nbrs[v].size());
+	}
+
+	//Contract by minimum degree, the remaining neighbours of a vertex become a clique
+	vector<char> contracted(n, false);
+	vector<unsigned int> mark(n, NO_EDGE);
+	this->rank.assign(n, 0);
+	for (unsigned int r = 0; !heap.empty(); r++) {
+		unsigned int v = heap.pop();
+		this->rank[v] = r;
+		contracted[v] = true;
+		for (unsigned int a : nbrs[v])
+			if (!contracted[a])
+				up[v].push_back(a);
+		vector<unsigned int>().swap(nbrs[v]);
+
+		for (unsigned int a : up[v]) {
+			vector<unsigned int> &adj = nbrs[a];
+			adj.erase(remove_if(adj.begin(), adj.end(), [&contracted] (unsigned int b) { return contracted[b]; }), adj.end());
+			for (unsigned int b : adj)
+				mark[b] = a;
+			for (unsigned int b : up[v])
+				if (b != a && mark[b] != a)
+					adj.push_back(b);
+			heap.changeKey(a, adj.size());
+		}
+	}
+
+	//Upward arcs
+	this->up_offsets.assign(n + 1, 0);
+	this->up_source.clear();
+	this->up_target.clear();
+	for (unsigned int v = 0; v < n; v++) {
+		sort(up[v].begin(), up[v].end());
+		for (unsigned int a : up[v]) {
+			this->up_source.push_back(v);
+			this->up_target.push_back(a);
+		}
+		this->up_offsets[v + 1] = this->up_target.size();
+		vector<unsigned int>().swap(up[v]);
+	}
+	unsigned int n_arcs = this->up_target.size();
+
+	//Downward arcs, sources come out sorted because arcs are sorted by source
+	this->down_offsets.assign(n + 1, 0);
+	for (unsigned int arc = 0; arc < n_arcs; arc++)
+		this->down_offsets[this->up_target[arc] + 1]++;
+	for (unsigned int v = 0; v < n; v++)
+		this->down_offsets[v + 1] += this->down_offsets[v];
+	this->down_source.assign(n_arcs, 0);
+	this->down_arc.assign(n_arcs, 0);
+	vector<unsigned int> fill(this->down_offsets.begin(), this->down_offsets.end() - 1);
+	for (unsigned int arc = 0; arc < n_arcs; arc++) {
+		unsigned int pos = fill[this->up_target[arc]]++;
+		this->down_source[pos] = this->up_source[arc];
+		this->down_arc[pos] = arc;
+	}
+
+	//Original edges behind each arc
+	this->up_edge.assign(n_arcs, NO_EDGE);
+	this->down_edge.assign(n_arcs, NO_EDGE);
+	this->edge_arc.assign(graph.getNumEdges(), NO_EDGE);
+	for (unsigned int v = 0; v < n; v++)
+		for (unsigned int e = graph.edgesBegin(v); e < graph.edgesEnd(v); e++) {
+			unsigned int t = graph.getTarget(e);
+			if (t == v)
+				continue;
+			if (this->rank[v] < this->rank[t]) {
+				this->edge_arc[e] = this->findArc(v, t);
+				this->up_edge[this->edge_arc[e]] = e;
+			} else {
+				this->edge_arc[e] = this->findArc(t, v);
+				this->down_edge[this->edge_arc[e]] = e;
+			}
+		}
+
+	this->queued.assign(n_arcs, false);
+	this->customize(graph);
+}
+
+void ContractionHierarchy::customize(const CSRGraph &graph) {
+	unsigned int n = this->rank.size(), n_arcs = this->up_target.size();
+	this->up_weight.resize(n_arcs);
+	this->down_weight.resize(n_arcs);
+	this->up_mid.assign(n_arcs, NO_EDGE);
+	this->down_mid.assign(n_arcs, NO_EDGE);
+	for (unsigned int arc = 0; arc < n_arcs; arc++) {
+		this->up_weight[arc] = edgeLength(graph, this->up_edge[arc]);
+		this->down_weight[arc] = edgeLength(graph, this->down_edge[arc]);
+	}
+
+	//Arcs leaving v are final once every lower triangle below v was relaxed
+	vector<unsigned int> order(n);
+	for (unsigned int v = 0; v < n; v++)
+		order[this->rank[v]] = v;
+	for (unsigned int v : order)
+		for (unsigned int x = this->up_offsets[v]; x < this->up_offsets[v + 1]; x++)
+			for (unsigned int y = x + 1; y < this->up_offsets[v + 1]; y++) {
+				unsigned int lo = x, hi = y;
+				if (this->rank[this->up_target[x]] > this->rank[this->up_target[y]])
+					swap(lo, hi);
+				unsigned int z = this->findArc(this->up_target[lo], this->up_target[hi]);
+				int w = addLength(this->down_weight[lo], this->up_weight[hi]);
+				if (w < this->up_weight[z]) {
+					this->up_weight[z] = w;
+					this->up_mid[z] = v;
+				}
+				w = addLength(this->down_weight[hi], this->up_weight[lo]);
+				if (w < this->down_weight[z]) {
+					this->down_weight[z] = w;
+					this->down_mid[z] = v;
+				}
+			}
+}
+
+bool ContractionHierarchy::recomputeArc(const CSRGraph &graph, unsigned int arc) {
+	unsigned int low = this->up_source[arc], high = this->up_target[arc];
+	int up_w = edgeLength(graph, this->up_edge[arc]), down_w = edgeLength(graph, this->down_edge[arc]);
+	unsigned int up_m = NO_EDGE, down_m = NO_EDGE;
+
+	unsigned int i = this->down_offsets[low], j = this->down_offsets[high];
+	while (i < this->down_offsets[low + 1] && j < this->down_offsets[high + 1]) {
+		if (this->down_source[i] < this->down_source[j])
+			i++;
+		else if (this->down_source[i] > this->down_source[j])
+			j++;
+		else {
+			unsigned int x = this->down_arc[i], y = this->down_arc[j];
+			int w = addLength(this->down_weight[x], this->up_weight[y]);
+			if (w < up_w) {
+				up_w = w;
+				up_m = this->down_source[i];
+			}
+			w = addLength(this->down_weight[y], this->up_weight[x]);
+			if (w < down_w) {
+				down_w = w;
+				down_m = this->down_source[i];
+			}
+			i++; j++;
+		}
+	}
+
+	bool changed = (up_w != this->up_weight[arc] || down_w != this->down_weight[arc]);
+	this->up_weight[arc] = up_w; this->up_mid[arc] = up_m;
+	this->down_weight[arc] = down_w; this->down_mid[arc] = down_m;
+	return changed;
+}
+
+void ContractionHierarchy::edgeChanged(const CSRGraph &graph, unsigned int edge) {
+	if (edge >= this->edge_arc.size() || this->edge_arc[edge] == NO_EDGE)
+		return;
+	typedef pair<unsigned int, unsigned int> RankArc;
+	priority_queue<RankArc, vector<RankArc>, greater<RankArc> > pending;
+	unsigned int arc = this->edge_arc[edge];
+	pending.push(RankArc(this->rank[this->up_source[arc]], arc));
+	this->queued[arc] = true;
+
+	//Arcs are recomputed from the bottom up, so their lower triangles are already final
+	while (!pending.empty()) {
+		arc = pending.top().second;
+		pending.pop();
+		this->queued[arc] = false;
+		if (!this->recomputeArc(graph, arc))
+			continue;
+		unsigned int low = this->up_source[arc], high = this->up_target[arc];
+		for (unsigned int y = this->up_offsets[low]; y < this->up_offsets[low + 1]; y++) {
+			unsigned int other = this->up_target[y];
+			if (y == arc)
+				continue;
+			unsigned int z = (this->rank[high] < this->rank[other]) ? this->findArc(high, other) : this->findArc(other, high);
+			if (!this->queued[z]) {
+				this->queued[z] = true;
+				pending.push(RankArc(this->rank[this->up_source[z]], z));
+			}
+		}
+	}
+}
+
+unsigned int ContractionHierarchy::findArc(unsigned int low, unsigned int high) const {
+	auto begin = this->up_target.begin() + this->up_offsets[low], end = this->up_target.begin() + this->up_offsets[low + 1];
+	auto it = lower_bound(begin, end, high);
+	if (it == end || *it != high)
+		return NO_EDGE;
+	return it - this->up_target.begin();
+}
+
+int ContractionHierarchy::query(unsigned int sourc, unsigned int dest, SearchWorkspace &forward, SearchWorkspace &backward,
+		vector<unsigned int> &path, unsigned long int &explored) const {
+	unsigned int n = this->rank.size(), meet = NO_EDGE;
+	int best = INT_MAX;
+	explored = 0;
+	path.clear();
+	forward.reset(n);
+	backward.reset(n);
+	forward.reach(sourc, 0, NO_EDGE, NO_EDGE);
+	forward.open_list.push(sourc, 0);
+	backward.reach(dest, 0, NO_EDGE, NO_EDGE);
+	backward.open_list.push(dest, 0);
+
+	while (true) {
+		bool f_open = !forward.open_list.empty() && forward.open_list.topKey() < best;
+		bool b_open = !backward.open_list.empty() && backward.open_list.topKey() < best;
+		if (!f_open && !b_open)
+			break;
+		bool up = f_open && (!b_open || forward.open_list.topKey() <= backward.open_list.topKey());
+		SearchWorkspace &ws = up ? forward : backward, &other = up ? backward : forward;
+		const vector<int> &weight = up ? this->up_weight : this->down_weight;
+
+		unsigned int u = ws.open_list.pop();
+		ws.close(u);
+		explored++;
+		if (other.getDist(u) != INT_MAX && ws.dist[u] + other.dist[u] < best) {
+			best = ws.dist[u] + other.dist[u];
+			meet = u;
+		}
+		for (unsigned int arc = this->up_offsets[u]; arc < this->up_offsets[u + 1]; arc++) {
+			if (weight[arc] == INT_MAX)
+				continue;
+			unsigned int v = this->up_target[arc];
+			int dist = ws.dist[u] + weight[arc];
+			if (dist < ws.getDist(v)) {
+				ws.reach(v, dist, u, arc);
+				ws.open_list.pushOrDecrease(v, dist);
+			}
+		}
+	}
+	if (meet == NO_EDGE)
+		return INT_MAX;
+
+	vector<unsigned int> arcs;
+	for (unsigned int v = meet; v != sourc; v = forward.parent[v])
+		arcs.push_back(forward.parent_edge[v]);
+	for (auto it = arcs.rbegin(); it != arcs.rend(); it++)
+		this->unpackArc(*it, true, path);
+	for (unsigned int v = meet; v != dest; v = backward.parent[v])
+		this->unpackArc(backward.parent_edge[v], false, path);
+	return best;
+}
+
+void ContractionHierarchy::unpackArc(unsigned int arc, bool up, vector<unsigned int> &path) const {
+	unsigned int mid = up ? this->up_mid[arc] : this->down_mid[arc];
+	if (mid == NO_EDGE) {
+		path.push_back(up ? this->up_edge[arc] : this->down_edge[arc]);
+		return;
+	}
+	unsigned int to_low = this->findArc(mid, this->up_source[arc]);
+	unsigned int to_high = this->findArc(mid, this->up_target[arc]);
+	if (up) { //low -> mid -> high
+		this->unpackArc(to_low, false, path);
+		this->unpackArc(to_high, true, path);
+	} else { //high -> mid -> low
+		this->unpackArc(to_high, false, path);
+		this->unpackArc(to_low, true, path);
+	}
+}
@@ -0,0 +1,115 @@
+#include "../headers/dynamic_sssp.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void DynamicSSSP::build(const CSRGraph &graph, unsigned int sourc) {
+	unsigned int n = graph.getNumVertex();
+	this->sourc = sourc;
+	this->dist.assign(n, INT_MAX);
+	this->parent.assign(n, NO_EDGE);
+	this->parent_edge.assign(n, NO_EDGE);
+	this->affected.assign(n, false);
+	this->open_list.resize(n);
+	this->dist[sourc] = 0;
+	this->open_list.push(sourc, 0);
+	this->propagate(graph);
+	this->repaired = 0;
+}
+
+void DynamicSSSP::edgeChanged(const CSRGraph &graph, unsigned int edge) {
+	unsigned int dest = graph.getTarget(edge);
+	if (graph.isBlocked(edge)) {
+		if (this->parent_edge[dest] == edge)
+			this->repairSubtree(graph, dest);
+		return;
+	}
+	//The edge is back, it can only make paths through it shorter
+	unsigned int orig = graph.getSource(edge);
+	if (this->dist[orig] == INT_MAX)
+		return;
+	int d = this->dist[orig] + graph.getWeight(edge);
+	if (d >= this->dist[dest])
+		return;
+	this->dist[dest] = d;
+	this->parent[dest] = orig;
+	this->parent_edge[dest] = edge;
+	this->open_list.push(dest, d);
+	this->propagate(graph);
+}
+
+void DynamicSSSP::repairSubtree(const CSRGraph &graph, unsigned int root) {
+	//Collect the subtree, the children of u are the targets of the edges they were reached through
+	vector<unsigned int> subtree(1, root);
+	this->affected[root] = true;
+	for (unsigned int i = 0; i < subtree.size(); i++) {
+		unsigned int u = subtree[i];
+		for (unsigned int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+			unsigned int v = graph.getTarget(e);
+			if (this->parent_edge[v] == e && !this->affected[v]) {
+				this->affected[v] = true;
+				subtree.push_back(v);
+			}
+		}
+	}
+	for (unsigned int v : subtree) {
+		this->dist[v] = INT_MAX;
+		this->parent[v] = NO_EDGE;
+		this->parent_edge[v] = NO_EDGE;
+	}
+
+	//Reattach each vertex of the subtree through its best in-neighbour outside of it
+	for (unsigned int v : subtree) {
+		for (unsigned int r = graph.reverseBegin(v); r < graph.reverseEnd(v); r++) {
+			unsigned int e = graph.getReverseEdge(r), u = graph.getReverseSource(r);
+			if (graph.isBlocked(e) || this->affected[u] || this->dist[u] == INT_MAX)
+				continue;
+			int d = this->dist[u] + graph.getWeight(e);
+			if (d < this->dist[v]) {
+				this->dist[v] = d;
+				this->parent[v] = u;
+				this->parent_edge[v] = e;
+			}
+		}
+		this->affected[v] = false;
+		if (this->dist[v] != INT_MAX)
+			this->open_list.push(v, this->dist[v]);
+	}
+	this->propagate(graph);
+}
+
+void DynamicSSSP::propagate(const CSRGraph &graph) {
+	while (!this->open_list.empty()) {
+		unsigned int u = this->open_list.pop();
+		this->repaired++;
+		for (unsigned int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+			if (graph.isBlocked(e)) //ignore if street cut or full
+				continue;
+			unsigned int v = graph.getTarget(e);
+			int d = this->dist[u] + graph.getWeight(e);
+			if (d < this->dist[v]) {
+				this->dist[v] = d;
+				this->parent[v] = u;
+				this->parent_edge[v] = e;
+				this->open_list.pushOrDecrease(v, d);
+			}
+		}
+	}
+}
+
+int DynamicSSSP::readPath(unsigned int dest, vector<unsigned int> &path) const {
+	path.clear();
+	if (this->dist[dest] == INT_MAX)
+		return INT_MAX;
+	for (unsigned int v = dest; v != this->sourc; v = this->parent[v])
+		path.push_back(this->parent_edge[v]);
+	reverse(path.begin(), path.end());
+	return this->dist[dest];
+}
+
+unsigned long int DynamicSSSP::takeRepaired() {
+	unsigned long int count = this->repaired;
+	this->repaired = 0;
+	return count;
+}
@@ -0,0 +1,114 @@
+#include "../headers/edit_distance.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Bits of the rows of a block that are part of the pattern
+ */
+static inline uint64_t rowMask(size_t length, size_t block) {
+	size_t rows = length - min(length, block * EDIT_WORD_BITS);
+	return (rows >= EDIT_WORD_BITS) ? ~0ULL : (1ULL << rows) - 1;
+}
+
+MyersPattern::MyersPattern(const string &pattern) : length(pattern.length()),
+		n_blocks(max((size_t) 1, (pattern.length() + EDIT_WORD_BITS - 1) / EDIT_WORD_BITS)), peq(256 * this->n_blocks, 0) {
+	for (size_t i = 0; i < this->length; i++)
+		this->peq[(unsigned char) pattern[i] * this->n_blocks + i / EDIT_WORD_BITS] |= 1ULL << (i % EDIT_WORD_BITS);
+}
+
+MyersPattern::Column MyersPattern::start() const {
+	Column column;
+	column.depth = 0;
+	column.bits.assign(2 * this->n_blocks, 0);
+	for (size_t b = 0; b < this->n_blocks; b++)
+		column.bits[2 * b] = ~0ULL; //the distance to the empty text grows by one every row
+	return column;
+}
+
+void MyersPattern::advance(Column &column, char chr, size_t n_blocks) const {
+	const uint64_t *eqs = this->peq.data() + (unsigned char) chr * this->n_blocks;
+	uint64_t *bits = column.bits.data();
+	int hin = 1; //the distance to the empty prefix grows by one every character
+	for (size_t b = 0; b < n_blocks; b++) {
+		uint64_t eq = eqs[b], pv = bits[2 * b], mv = bits[2 * b + 1];
+		uint64_t xv = eq | mv;
+		if (hin < 0)
+			eq |= 1;
+		uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+		uint64_t ph = mv | ~(xh | pv);
+		uint64_t mh = pv & xh;
+		int hout = (ph >> (EDIT_WORD_BITS - 1)) ? 1 : (mh >> (EDIT_WORD_BITS - 1)) ? -1 : 0;
+		ph <<= 1;
+		mh <<= 1;
+		if (hin < 0)
+			mh |= 1;
+		else if (hin > 0)
+			ph |= 1;
+		bits[2 * b] = mh | ~(xv | ph);
+		bits[2 * b + 1] = ph & xv;
+		hin = hout;
+	}
+	column.depth++;
+}
+
+unsigned int MyersPattern::distance(const Column &column) const {
+	int dist = column.depth;
+	for (size_t b = 0; b < this->n_blocks; b++) {
+		uint64_t mask = rowMask(this->length, b);
+		dist += __builtin_popcountll(column.bits[2 * b] & mask) - __builtin_popcountll(column.bits[2 * b + 1] & mask);
+	}
+	return dist;
+}
+
+unsigned int MyersPattern::minimum(const Column &column) const {
+	int best = column.depth, base = column.depth;
+	for (size_t b = 0; b < this->n_blocks; b++) {
+		uint64_t mask = rowMask(this->length, b);
+		uint64_t pv = column.bits[2 * b] & mask, mv = column.bits[2 * b + 1] & mask;
+		//the minimum is right after a decrease, or at the empty prefix
+		for (uint64_t down = mv; down != 0; down &= down - 1) {
+			int row = __builtin_ctzll(down);
+			uint64_t upto = (row == EDIT_WORD_BITS - 1) ? ~0ULL : (2ULL << row) - 1;
+			best = min(best, base + __builtin_popcountll(pv & upto) - __builtin_popcountll(mv & upto));
+		}
+		base += __builtin_popcountll(pv) - __builtin_popcountll(mv);
+	}
+	return best;
+}
+
+unsigned int MyersPattern::distance(const string &text) const {
+	Column column = this->start();
+	for (char chr : text)
+		this->advance(column, chr);
+	return this->distance(column);
+}
+
+unsigned int MyersPattern::distance(const string &text, unsigned int max_dist) const {
+	size_t n = text.length(), m = this->length;
+	if ((n > m ? n - m : m - n) > max_dist)
+		return max_dist + 1;
+	if (max_dist >= max(n, m)) //a distance is never above the longest string
+		return this->distance(text);
+	size_t k = max_dist;
+	Column column = this->start();
+	for (size_t j = 1; j <= n; j++) {
+		//rows more than k below the diagonal are more than k away, the blocks above them can wait
+		size_t active = min(this->n_blocks, (j + k + EDIT_WORD_BITS - 1) / EDIT_WORD_BITS);
+		this->advance(column, text[j - 1], active);
+		//every remaining character lowers the distance by one at most
+		if (active == this->n_blocks && this->distance(column) > k + (n - j))
+			return max_dist + 1;
+	}
+	unsigned int dist = this->distance(column);
+	return (dist > max_dist) ? max_dist + 1 : dist;
+}
+
+unsigned int editDistance(const string &pattern, const string &text) {
+	return MyersPattern(pattern).distance(text);
+}
+
+unsigned int boundedEditDistance(const string &pattern, const string &text, unsigned int max_dist) {
+	return MyersPattern(pattern).distance(text, max_dist);
+}
@@ -0,0 +1,60 @@
+#include "../headers/geometry.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_AVX2_KERNEL
+#endif
+
+using namespace std;
+
+/**
+ * @brief Scalar distances of the pairs [begin, end)
+ */
+static void scalarDistances(const UnitVectorArray &a, const UnitVectorArray &b, unsigned int begin, unsigned int end, int *out) {
+	for (unsigned int i = begin; i < end; i++) {
+		double dx = a.x[i] - b.x[i], dy = a.y[i] - b.y[i], dz = a.z[i] - b.z[i];
+		out[i] = ceil(arcLength(sqrt(dx * dx + dy * dy + dz * dz) / 2));
+	}
+}
+
+#ifdef HAS_AVX2_KERNEL
+/**
+ * @brief Distances of the pairs [0, n) four at a time, the groups with a long arc are redone by scalarDistances
+ * @return Number of pairs done (a multiple of 4), the rest is left to the caller
+ * @detail Multiplies and adds are kept apart (no FMA) so the rounding matches the scalar code exactly
+ */
+__attribute__((target("avx2")))
+static unsigned int avx2Distances(const UnitVectorArray &a, const UnitVectorArray &b, unsigned int n, int *out) {
+	const __m256d small = _mm256_set1_pd(SMALL_HALF_CHORD);
+	const __m256d c7 = _mm256_set1_pd(5.0 / 112), c5 = _mm256_set1_pd(3.0 / 40), c3 = _mm256_set1_pd(1.0 / 6);
+	const __m256d diameter = _mm256_set1_pd(2 * EARTH_RADIUS_M);
+	unsigned int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&a.x[i]), _mm256_loadu_pd(&b.x[i]));
+		__m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&a.y[i]), _mm256_loadu_pd(&b.y[i]));
+		__m256d dz = _mm256_sub_pd(_mm256_loadu_pd(&a.z[i]), _mm256_loadu_pd(&b.z[i]));
+		__m256d sq = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+		__m256d h = _mm256_div_pd(_mm256_sqrt_pd(sq), _mm256_set1_pd(2));
+		if (_mm256_movemask_pd(_mm256_cmp_pd(h, small, _CMP_LT_OQ)) != 0xF) {
+			scalarDistances(a, b, i, i + 4, out);
+			continue;
+		}
+		__m256d h2 = _mm256_mul_pd(h, h);
+		__m256d series = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(c7, h2), c5), h2), c3), h2);
+		__m256d arc = _mm256_mul_pd(diameter, _mm256_add_pd(h, _mm256_mul_pd(h, series)));
+		__m128i rounded = _mm256_cvtpd_epi32(_mm256_ceil_pd(arc));
+		_mm_storeu_si128((__m128i *) &out[i], rounded);
+	}
+	return i;
+}
+#endif
+
+void batchGreatCircleDistance(const UnitVectorArray &a, const UnitVectorArray &b, vector<int> &distances) {
+	unsigned int n = a.size(), done = 0;
+	distances.resize(n);
+#ifdef HAS_AVX2_KERNEL
+	if (__builtin_cpu_supports("avx2"))
+		done = avx2Distances(a, b, n, distances.data());
+#endif
+	scalarDistances(a, b, done, n, distances.data());
+}
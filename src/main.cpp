@@ -1,4 +1,5 @@
 #include "../headers/ui.h"
+#include "../headers/snapshot.h"
 #include <iostream>
 #include <chrono>
 #include <time.h>
@@ -7,9 +8,8 @@
 
 void initGraph(Graph<long long int> &graph){
 	std::chrono::high_resolution_clock::time_point current = std::chrono::high_resolution_clock::now();
-	loadNodes(graph);
-	loadEdges(graph);
-	loadStreets(graph);
+	if (!loadSnapshot(graph, SNAPSHOT_FILE)) //missing or made from other files
+		loadGraph(graph);
 	std::chrono::high_resolution_clock::time_point final = std::chrono::high_resolution_clock::now();
 	cout << "   Loading Time: " << std::chrono::duration_cast<std::chrono::duration<double>>(final - current).count() << "s\n";
 }
@@ -34,7 +34,23 @@ void run() {
 	delete gv;
 }
 
-int main() {
+/**
+	@brief Loads the text files and writes the snapshot that later runs start from
+*/
+int writeSnapshot() {
+	Graph<long long int> graph;
+	loadGraph(graph);
+	if (!saveSnapshot(graph, SNAPSHOT_FILE)) {
+		cout << "Failed to write " << SNAPSHOT_FILE << "!\n";
+		return 1;
+	}
+	cout << "Snapshot written to " << SNAPSHOT_FILE << "\n";
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && string(argv[1]) == "--snapshot")
+		return writeSnapshot();
 	run();
 	return 0;
 }
@@ -0,0 +1,33 @@
+#include "../headers/mapped_file.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const char *file_name) {
+	int fd = open(file_name, O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			this->data = (const char *) map;
+			this->size = info.st_size;
+		}
+	}
+	close(fd); //the mapping stays valid
+}
+
+MappedFile::~MappedFile() {
+	if (this->data != nullptr)
+		munmap((void *) this->data, this->size);
+}
+
+uint64_t fileSize(const char *file_name) {
+	struct stat info;
+	if (stat(file_name, &info) != 0)
+		return 0;
+	return info.st_size;
+}
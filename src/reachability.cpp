@@ -0,0 +1,100 @@
+#include "../headers/reachability.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Vertexes of the frontier handed to a worker at once by the top-down levels (words of 64 vertexes for bottom-up)
+ */
+static const unsigned int BFS_BLOCK = 1024;
+
+static inline unsigned int degree(const CSRGraph &graph, unsigned int v) {
+	return graph.edgesEnd(v) - graph.edgesBegin(v);
+}
+
+unsigned long int Reachability::explore(const CSRGraph &graph, unsigned int root, WorkerPool &pool) {
+	unsigned int n = graph.getNumVertex();
+	unsigned int words = (n + 63) / 64;
+	this->visited.assign(words, 0);
+	this->frontier_bits.assign(words, 0);
+	this->next.resize(pool.size());
+	this->frontier.assign(1, root);
+	this->visited[root >> 6] |= (uint64_t) 1 << (root & 63);
+	this->count = 1;
+
+	unsigned long int frontier_edges = degree(graph, root);
+	unsigned long int unexplored_edges = graph.getNumEdges() - frontier_edges;
+	bool bottom_up = false;
+	while (!this->frontier.empty()) {
+		if (!bottom_up && frontier_edges > unexplored_edges / BFS_ALPHA)
+			bottom_up = true;
+		else if (bottom_up && this->frontier.size() < n / BFS_BETA)
+			bottom_up = false;
+
+		for (vector<unsigned int> &level : this->next)
+			level.clear();
+		if (bottom_up)
+			this->bottomUp(graph, pool);
+		else
+			this->topDown(graph, pool);
+
+		this->frontier.clear();
+		frontier_edges = 0;
+		for (const vector<unsigned int> &level : this->next)
+			for (unsigned int v : level) {
+				this->frontier.push_back(v);
+				frontier_edges += degree(graph, v);
+			}
+		this->count += this->frontier.size();
+		unexplored_edges -= min(unexplored_edges, frontier_edges);
+	}
+	return this->count;
+}
+
+void Reachability::topDown(const CSRGraph &graph, WorkerPool &pool) {
+	unsigned int size = this->frontier.size();
+	pool.parallelFor((size + BFS_BLOCK - 1) / BFS_BLOCK, [this, &graph, size] (unsigned int block, unsigned int worker) {
+		vector<unsigned int> &level = this->next[worker];
+		for (unsigned int i = block * BFS_BLOCK; i < min(size, (block + 1) * BFS_BLOCK); i++) {
+			unsigned int u = this->frontier[i];
+			for (unsigned int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+				unsigned int v = graph.getTarget(e);
+				uint64_t bit = (uint64_t) 1 << (v & 63), *word = &this->visited[v >> 6];
+				if (__atomic_load_n(word, __ATOMIC_RELAXED) & bit)
+					continue;
+				if (!(__atomic_fetch_or(word, bit, __ATOMIC_RELAXED) & bit)) //this worker claimed it
+					level.push_back(v);
+			}
+		}
+	});
+}
+
+void Reachability::bottomUp(const CSRGraph &graph, WorkerPool &pool) {
+	unsigned int n = graph.getNumVertex(), words = this->visited.size();
+	fill(this->frontier_bits.begin(), this->frontier_bits.end(), 0);
+	for (unsigned int v : this->frontier)
+		this->frontier_bits[v >> 6] |= (uint64_t) 1 << (v & 63);
+
+	//Each worker owns whole words of the bitmap, so no atomics are needed
+	pool.parallelFor((words + BFS_BLOCK - 1) / BFS_BLOCK, [this, &graph, n, words] (unsigned int block, unsigned int worker) {
+		vector<unsigned int> &level = this->next[worker];
+		for (unsigned int w = block * BFS_BLOCK; w < min(words, (block + 1) * BFS_BLOCK); w++) {
+			uint64_t unvisited = ~this->visited[w];
+			if (w == words - 1 && n % 64 != 0)
+				unvisited &= ((uint64_t) 1 << (n % 64)) - 1;
+			while (unvisited != 0) {
+				unsigned int b = __builtin_ctzll(unvisited), v = w * 64 + b;
+				unvisited &= unvisited - 1;
+				for (unsigned int r = graph.reverseBegin(v); r < graph.reverseEnd(v); r++) {
+					unsigned int u = graph.getReverseSource(r);
+					if ((this->frontier_bits[u >> 6] >> (u & 63)) & 1) {
+						this->visited[w] |= (uint64_t) 1 << b;
+						level.push_back(v);
+						break;
+					}
+				}
+			}
+		}
+	});
+}
@@ -0,0 +1,147 @@
+#include "../headers/scc.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+void ComponentIndex::build(const CSRGraph &graph) {
+	unsigned int n = graph.getNumVertex(), m = graph.getNumEdges();
+	this->comp.assign(n, NO_EDGE);
+	this->members.clear();
+	this->exits.clear();
+	this->cut.resize(m);
+	for (unsigned int e = 0; e < m; e++)
+		this->cut[e] = this->isCut(graph, e);
+	this->scope.assign(n, 0);
+	this->index.assign(n, NO_EDGE);
+	this->low.assign(n, 0);
+	this->on_stack.assign(n, false);
+	this->generation = 0;
+	this->reached.clear();
+	this->reach_generation = 0;
+
+	vector<unsigned int> all(n);
+	for (unsigned int v = 0; v < n; v++)
+		all[v] = v;
+	this->tarjan(graph, all, NO_EDGE);
+	this->stale = false;
+}
+
+void ComponentIndex::edgeChanged(const CSRGraph &graph, unsigned int edge) {
+	if (this->cut.size() <= edge)
+		return;
+	bool now = this->isCut(graph, edge);
+	if (now == (bool) this->cut[edge])
+		return;
+	this->cut[edge] = now;
+	if (this->stale)
+		return;
+	unsigned int orig = graph.getSource(edge), dest = graph.getTarget(edge);
+	if (now && this->comp[orig] == this->comp[dest]) {
+		unsigned int c = this->comp[orig];
+		vector<unsigned int> vertices = this->members[c];
+		this->tarjan(graph, vertices, c);
+	}
+	else if (!now && this->comp[orig] != this->comp[dest])
+		this->stale = true; //may merge components
+}
+
+void ComponentIndex::tarjan(const CSRGraph &graph, const vector<unsigned int> &vertices, unsigned int reuse) {
+	if (++this->generation == 0) {
+		fill(this->scope.begin(), this->scope.end(), 0);
+		this->generation = 1;
+	}
+	for (unsigned int v : vertices) {
+		this->scope[v] = this->generation;
+		this->index[v] = NO_EDGE;
+	}
+
+	vector< pair<unsigned int, unsigned int> > call; //vertex and next edge to follow
+	vector<unsigned int> stack;
+	unsigned int counter = 0;
+	for (unsigned int root : vertices) {
+		if (this->index[root] != NO_EDGE)
+			continue;
+		this->index[root] = this->low[root] = counter++;
+		stack.push_back(root);
+		this->on_stack[root] = true;
+		call.push_back(make_pair(root, graph.edgesBegin(root)));
+
+		while (!call.empty()) {
+			unsigned int v = call.back().first, e = call.back().second;
+			if (e < graph.edgesEnd(v)) {
+				call.back().second++;
+				unsigned int w = graph.getTarget(e);
+				if (this->isCut(graph, e) || this->scope[w] != this->generation)
+					continue;
+				if (this->index[w] == NO_EDGE) {
+					this->index[w] = this->low[w] = counter++;
+					stack.push_back(w);
+					this->on_stack[w] = true;
+					call.push_back(make_pair(w, graph.edgesBegin(w)));
+				}
+				else if (this->on_stack[w])
+					this->low[v] = min(this->low[v], this->index[w]);
+				continue;
+			}
+
+			call.pop_back();
+			if (!call.empty())
+				this->low[call.back().first] = min(this->low[call.back().first], this->low[v]);
+			if (this->low[v] != this->index[v])
+				continue;
+
+			//v is the root of a component, which is on top of the stack
+			unsigned int id = reuse;
+			if (id == NO_EDGE) {
+				id = this->members.size();
+				this->members.emplace_back();
+				this->exits.emplace_back();
+				this->reached.push_back(0);
+			}
+			reuse = NO_EDGE;
+			vector<unsigned int> &component = this->members[id];
+			component.clear();
+			unsigned int w;
+			do {
+				w = stack.back();
+				stack.pop_back();
+				this->on_stack[w] = false;
+				this->comp[w] = id;
+				component.push_back(w);
+			} while (w != v);
+
+			//Components are found sinks first, so every road leaving this one already leads to its final component
+			vector<unsigned int> &leaving = this->exits[id];
+			leaving.clear();
+			for (unsigned int u : component)
+				for (unsigned int f = graph.edgesBegin(u); f < graph.edgesEnd(u); f++)
+					if (this->comp[graph.getTarget(f)] != id)
+						leaving.push_back(f);
+		}
+	}
+}
+
+unsigned long int ComponentIndex::markReachable(const CSRGraph &graph, unsigned int sourc) {
+	if (++this->reach_generation == 0) {
+		fill(this->reached.begin(), this->reached.end(), 0);
+		this->reach_generation = 1;
+	}
+	unsigned long int count = 0;
+	vector<unsigned int> stack(1, this->comp[sourc]);
+	this->reached[this->comp[sourc]] = this->reach_generation;
+	while (!stack.empty()) {
+		unsigned int c = stack.back();
+		stack.pop_back();
+		count += this->members[c].size();
+		for (unsigned int e : this->exits[c]) {
+			unsigned int next = this->comp[graph.getTarget(e)];
+			if (this->isCut(graph, e) || this->reached[next] == this->reach_generation)
+				continue;
+			this->reached[next] = this->reach_generation;
+			stack.push_back(next);
+		}
+	}
+	return count;
+}
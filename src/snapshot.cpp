@@ -0,0 +1,7 @@
+#include "../headers/snapshot.h"
+
+void sourceSizes(uint64_t sizes[3]) {
+	sizes[0] = fileSize(NODES_FILE);
+	sizes[1] = fileSize(EDGES_FILE);
+	sizes[2] = fileSize(STREETS_FILE);
+}
@@ -0,0 +1,122 @@
+#include "../headers/text_parser.h"
+#include "../headers/mapped_file.h"
+
+#include <charconv>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Calls line(begin, end) for every line of [begin, end) that is not blank, without its "\r\n" or "\n"
+ */
+template<class Line>
+static void forEachLine(const char *begin, const char *end, Line line) {
+	while (begin < end) {
+		const char *eol = (const char *) memchr(begin, '\n', end - begin);
+		if (eol == nullptr)
+			eol = end;
+		const char *last = eol;
+		if (last > begin && last[-1] == '\r')
+			last--;
+		if (last > begin)
+			line(begin, last);
+		begin = eol + 1;
+	}
+}
+
+/**
+ * @brief Reads a number and the ';' after it (if the line goes on), moving begin past them
+ * @return Whether there was a number
+ */
+template<class Number>
+static bool readField(const char *&begin, const char *end, Number &value) {
+	from_chars_result result = from_chars(begin, end, value);
+	if (result.ec != errc())
+		return false;
+	begin = result.ptr;
+	if (begin < end) {
+		if (*begin != ';')
+			return false;
+		begin++;
+	}
+	return true;
+}
+
+/**
+ * @brief Parses every line of a file into records, in parallel (see parseNodes)
+ * @param[in] parse Called as parse(begin, end, record) for every line, returns whether the line was well formed
+ */
+template<class Record, class Parse>
+static bool parseFile(const char *file_name, WorkerPool &pool, vector<Record> &records, Parse parse) {
+	records.clear();
+	MappedFile file(file_name);
+	if (!file.isOpen())
+		return false;
+	const char *data = file.getData(), *end = data + file.getSize();
+
+	//chunks start right after a newline
+	unsigned int n_chunks = pool.size() * CHUNKS_PER_WORKER;
+	vector<const char *> bounds(n_chunks + 1, end);
+	bounds[0] = data;
+	for (unsigned int i = 1; i < n_chunks; i++) {
+		const char *p = max(bounds[i - 1], data + file.getSize() * i / n_chunks);
+		if (p > data && p < end) {
+			p = (const char *) memchr(p - 1, '\n', end - (p - 1));
+			p = (p == nullptr) ? end : p + 1;
+		}
+		bounds[i] = p;
+	}
+
+	vector<size_t> first(n_chunks + 1, 0);
+	pool.parallelFor(n_chunks, [&bounds, &first] (unsigned int chunk, unsigned int) {
+		size_t count = 0;
+		forEachLine(bounds[chunk], bounds[chunk + 1], [&count] (const char *, const char *) { count++; });
+		first[chunk + 1] = count;
+	});
+	for (unsigned int i = 0; i < n_chunks; i++)
+		first[i + 1] += first[i];
+
+	records.resize(first[n_chunks]);
+	atomic<bool> well_formed(true);
+	pool.parallelFor(n_chunks, [&bounds, &first, &records, &well_formed, &parse] (unsigned int chunk, unsigned int) {
+		size_t k = first[chunk];
+		forEachLine(bounds[chunk], bounds[chunk + 1], [&k, &records, &well_formed, &parse] (const char *begin, const char *end) {
+			if (!parse(begin, end, records[k++]))
+				well_formed.store(false, memory_order_relaxed);
+		});
+	});
+	return well_formed.load();
+}
+
+bool parseNodes(const char *file_name, WorkerPool &pool, vector<NodeRecord> &records) {
+	return parseFile(file_name, pool, records, [] (const char *begin, const char *end, NodeRecord &node) {
+		double latitudeDegrees, longitudeDegrees;
+		return readField(begin, end, node.id) && readField(begin, end, latitudeDegrees)
+				&& readField(begin, end, longitudeDegrees) && readField(begin, end, node.longitude)
+				&& readField(begin, end, node.latitude);
+	});
+}
+
+bool parseEdges(const char *file_name, WorkerPool &pool, vector<EdgeRecord> &records) {
+	return parseFile(file_name, pool, records, [] (const char *begin, const char *end, EdgeRecord &edge) {
+		return readField(begin, end, edge.id) && readField(begin, end, edge.sourc) && readField(begin, end, edge.dest);
+	});
+}
+
+bool parseStreets(const char *file_name, WorkerPool &pool, vector<StreetRecord> &records) {
+	return parseFile(file_name, pool, records, [] (const char *begin, const char *end, StreetRecord &street) {
+		if (!readField(begin, end, street.id))
+			return false;
+		const char *name_end = (const char *) memchr(begin, ';', end - begin);
+		if (name_end == nullptr)
+			return false;
+		street.name.assign(begin, name_end);
+		begin = name_end + 1;
+		while (begin < end && *begin == ' ')
+			begin++;
+		street.two_ways = (begin < end && *begin == 'T');
+		return true;
+	});
+}
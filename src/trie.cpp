@@ -7,304 +7,231 @@
 
 using namespace std;
 
-static mutex flag;
-
 /**
- * @brief Converts from array position to ASCII notation
- * @param[in] chr Char to convert
- * @return The ASCII representation of the character
- * @detail Time Complexity O(1), Space Complexity O(1)
- */
-unsigned char arrPosToChar(char chr) {
-	if (chr >= 0 && chr < ALPHABET_SIZE) //Letter
-		return chr + ALPHABET_BEGINNING;
-	else if (chr >= ALPHABET_SIZE && chr < (ALPHABET_SIZE + NUMBER_SIZE)) //Number
-		return (chr + NUMBER_BEGGINING) - ALPHABET_SIZE;
-	else
-		//Space
-		return 32;
-}
-
-/**
- * @brief Counts the number of elements of this level of the trie
- * @param[in] arr Base level to search
- * @return How many elements it has
- */
-unsigned char numberOfElements(const node_t arr) {
-	unsigned char cont = 0;
-	for (unsigned char i = 0; i < ARR_SIZE && (arr.next != nullptr || arr.eow);
-			i++)
-		if (arr.eow || arr.next[i].next != nullptr || arr.next[i].eow)
-			cont++;
+	@brief State shared by the tasks of one approximate search
+	@var pattern Word to find match, in upper case
+	@var k Maximum number of matches
+	@var cutoff Distance from which words are no longer wanted: max_distance + 1, then the distance of the k-th match
+	once there are k, so only closer words are taken (only ever lowered, under lock)
+	@var lock Guards best
+	@var best Closest words found so far with their distances, at most k
+*/
+struct FuzzySearch {
+	const MyersPattern pattern;
+	const size_t k;
+	atomic<unsigned int> cutoff;
+	mutex lock;
+	set< pair<unsigned int, string> > best;
+
+	FuzzySearch(const string &word, unsigned int max_distance, size_t k) : pattern(word), k(k), cutoff(min(max_distance, UINT_MAX - 1) + 1) {}
+
+	/**
+		@brief Keeps a word if it is among the k closest so far
+	*/
+	void offer(unsigned int dist, const string &word) {
+		lock_guard<mutex> guard(this->lock);
+		if (dist >= this->cutoff.load(memory_order_relaxed))
+			return;
+		this->best.insert( make_pair(dist, word) );
+		if (this->best.size() > this->k)
+			this->best.erase(prev(this->best.end()));
+		if (this->best.size() == this->k)
+			this->cutoff.store(this->best.rbegin()->first, memory_order_relaxed);
+	}
+};
 
-	return cont;
-}
+Trie::Trie() : nodes(1) {}
 
-/**
- * @brief Computates the edit distance between the pattern and the text
- * @param[in] pattern The pattern to search for
- * @param[in] text The text to search in
- * @return The edit distance between the two parameters
- * @detail From solution of the TP11
- */
-unsigned int editDistance(string &pattern, string &text) {
-	std::transform(pattern.begin(), pattern.end(), pattern.begin(), ::toupper);
-	std::transform(text.begin(), text.end(), text.begin(), ::toupper);
-	int n = text.length();
-	vector<int> d(n + 1);
-	int old, neww;
-	for (int j = 0; j <= n; j++)
-		d[j] = j;
-	int m = pattern.length();
-	for (int i = 1; i <= m; i++) {
-		old = d[0];
-		d[0] = i;
-		for (int j = 1; j <= n; j++) {
-			if (pattern[i - 1] == text[j - 1])
-				neww = old;
-			else {
-				neww = min(old, d[j]);
-				neww = min(neww, d[j - 1]);
-				neww = neww + 1;
-			}
-			old = d[j];
-			d[j] = neww;
+void Trie::insertWord(const string &word) {
+	if (word.empty())
+		return;
+	string upper = word;
+	for (char &chr : upper) {
+		if (this->charToArrPos(chr) < 0) {
+			cout << "!UNKNOWN LETTER!\n	ABORTING \n";
+			exit(1);
 		}
+		chr = toupper(chr);
 	}
-	return d[n];
-}
-
-/**
- * @brief Finds the position of the first element of the array
- * @param[in] arr Array to search
- * @return Position of the first element
- * @detail Used only in suffixDFS in array which only have 1 element. Time Complexity O(n) , Space Complexity O(1)
- */
-int findFirstElementPos(const node_t *arr) {
-	for (unsigned char pos = 0; pos < ARR_SIZE && arr != nullptr; pos++)
-		if (arr[pos].next != nullptr || arr[pos].eow)
-			return pos;
-
-	return -1;
+	this->staged.push_back(upper);
 }
 
-/**
- * @brief Checks the character exists in the next level of the trie
- * @param[in] chr Character to check the existance
- * @param[in] arr Base node
- * @return Position in the array where the character occurs, or -1 if it does not occur
- */
-int Trie::charExistsInArr(const char &chr, const node_t *arr) const {
-	int i = 0;
-	for (i = 0; i < ARR_SIZE; i++) {
-		if (arr[i].next != nullptr
-				&& arr[i].next[charToArrPos(chr)].next != nullptr
-				&& arr[i].eow == false)
-			return i;
-
+void Trie::build() {
+	vector<string> words;
+	words.swap(this->staged);
+	//words already in the tree
+	vector< pair<uint32_t, string> > stack;
+	stack.push_back( make_pair(0, string()) );
+	while (!stack.empty()) {
+		pair<uint32_t, string> top = stack.back();
+		stack.pop_back();
+		const radix_node_t &node = this->nodes[top.first];
+		string prefix = top.second + this->label(top.first);
+		if (node.eow)
+			words.push_back(prefix);
+		for (uint64_t bits = node.children, child = node.first_child; bits != 0; bits &= bits - 1, child++)
+			stack.push_back( make_pair(child, prefix) );
 	}
-
-	return -1;
-}
-
-Trie::Trie() {
-	this->root.next = new node_t[ARR_SIZE];
-	this->root.eow = false;
-}
-
-void Trie::insertWord(const string &word) {
-	size_t i = 0;
-	node_t *temp = this->root.next;
-	for (i = 0; i < word.length() - 1; i++) {
-		unsigned char pos = charToArrPos(word[i]);
-		if (temp[pos].next == nullptr)
-			temp[pos].next = new node_t[ARR_SIZE];
-
-		temp = temp[pos].next;
+	//in the order of the children bits, so siblings can be laid out in that order
+	sort(words.begin(), words.end(), [this] (const string &a, const string &b) {
+		return lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [this] (char x, char y) {
+			return this->charToArrPos(x) < this->charToArrPos(y);
+		});
+	});
+	words.erase(unique(words.begin(), words.end()), words.end());
+
+	this->nodes.assign(1, radix_node_t());
+	this->labels.clear();
+	if (words.empty())
+		return;
+	struct Range {
+		uint32_t node;
+		size_t lo, hi, depth;
+	};
+	queue<Range> pending;
+	pending.push( Range{0, 0, words.size(), 0} );
+	while (!pending.empty()) {
+		Range range = pending.front();
+		pending.pop();
+		//the node is the common prefix of its words, the first and last are enough as they are sorted
+		const string &first = words[range.lo], &last = words[range.hi - 1];
+		size_t end = range.depth;
+		while (end < first.size() && end < last.size() && first[end] == last[end])
+			end++;
+		this->nodes[range.node].label_offset = this->labels.size();
+		this->nodes[range.node].label_size = end - range.depth;
+		this->labels.append(first, range.depth, end - range.depth);
+		size_t lo = range.lo;
+		if (first.size() == end) {
+			this->nodes[range.node].eow = true;
+			lo++;
+		}
+		if (lo < range.hi)
+			this->nodes[range.node].first_child = this->nodes.size();
+		while (lo < range.hi) {
+			char chr = words[lo][end];
+			size_t hi = lo;
+			while (hi < range.hi && words[hi][end] == chr)
+				hi++;
+			this->nodes[range.node].children |= 1ULL << this->charToArrPos(chr);
+			pending.push( Range{(uint32_t) this->nodes.size(), lo, hi, end} );
+			this->nodes.push_back(radix_node_t());
+			lo = hi;
+		}
 	}
-	if (i == word.length() - 1) // Might as well check
-		temp[charToArrPos(word[i])].eow = true;
+	this->nodes.shrink_to_fit();
+	this->labels.shrink_to_fit();
 }
 
-unsigned char Trie::charToArrPos(char chr) const {
+int Trie::charToArrPos(char chr) const {
 	if ((chr >= 65 && chr <= 90) || (chr >= 97 && chr <= 122)) //Letter
 		return (toupper(chr) - ALPHABET_BEGINNING);
 	else if (chr >= 48 && chr <= 57) //Number
 		return (ALPHABET_SIZE + (chr - NUMBER_BEGGINING));
 	else if (chr == 32) //Space
 		return (ALPHABET_SIZE + 10);
-	else {
-		cout << "!UNKNOWN LETTER!\n	ABORTING \n";
-		exit(1);
-	}
+	else
+		return -1;
 }
 
-
-void Trie::printArr(const node_t *arr) const {
-	for (int i = 0; i < ARR_SIZE && arr != nullptr; i++)
-		cout << arrPosToChar(i) << " - [ " << arr[i].eow << "|" << arr[i].next
-				<< "]\n";
+uint32_t Trie::childOf(uint32_t node, char chr) const {
+	int pos = this->charToArrPos(chr);
+	if (pos < 0 || ((this->nodes[node].children >> pos) & 1) == 0)
+		return NO_NODE;
+	return this->nodes[node].first_child + __builtin_popcountll(this->nodes[node].children & ((1ULL << pos) - 1));
 }
 
 bool Trie::exactWordSearch(string &word) const {
-	node_t *temp = this->root.next;
-	unsigned int i = 0;
-	unsigned char pos = charToArrPos(word[i]);
-	for (i = 0; i < word.length() - 1; i++, pos = charToArrPos(word[i])) {
-		if (temp[pos].next == nullptr)
-			break;
-
-		temp = temp[pos].next;
+	const radix_node_t *nodes = this->nodes.data(), *n = nodes;
+	const char *labels = this->labels.data(), *chr = word.data(), *end = chr + word.length();
+	while (chr != end) {
+		if ((size_t) (end - chr) < n->label_size)
+			return false;
+		for (const char *label = labels + n->label_offset, *label_end = label + n->label_size; label != label_end; label++, chr++)
+			if (*chr != *label && toupper(*chr) != *label)
+				return false;
+		if (chr == end)
+			return n->eow;
+		int pos = this->charToArrPos(*chr);
+		if (pos < 0 || ((n->children >> pos) & 1) == 0)
+			return false;
+		n = nodes + n->first_child + __builtin_popcountll(n->children & ((1ULL << pos) - 1));
 	}
-	return ((i == word.length() - 1) && temp[charToArrPos(word[i])].eow);
+	return false;
 }
 
-list<string> *Trie::approximateWordSearch(string &word) const {
-	unsigned int *min_dist = new unsigned int;
-	*min_dist = this->findInitK(word);
-	list<string> *results = new list<string>;
-	thread(suffixDFS, word, "", this->root, min_dist, results).join();
+vector<fuzzy_match_t> Trie::approximateWordSearch(const string &word, unsigned int max_distance, size_t k) const {
+	vector<fuzzy_match_t> results;
+	if (k == 0)
+		return results;
+	string upper = word, closest;
+	std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+	FuzzySearch search(upper, max_distance, k);
+	unsigned int dist = this->findInitK(search.pattern, closest);
+	if (dist != UINT_MAX)
+		search.offer(dist, closest);
+	this->pool.run([this, &search] (unsigned int worker) {
+		this->suffixDFS(search, "", search.pattern.start(), 0, worker);
+	});
+	results.reserve(search.best.size());
+	for (const pair<unsigned int, string> &match : search.best)
+		results.push_back( fuzzy_match_t{match.second, match.first} );
 	return results;
 }
 
-void Trie::suffixDFS(const string &word, const string pref, node_t chr, unsigned int *min_dist, list<string> *results) {
-	string preffix = pref, tmp_word;
-	unsigned int dist = 0, n_elems = 0;
-	int pos = 0;
-	list<thread> all_threads;
-
-	while (((n_elems = numberOfElements(chr)) == 1 && ((pos = findFirstElementPos(chr.next)) != -1))) {
-		if (!chr.eow) {
-			preffix += (char) arrPosToChar(pos);
-			chr = chr.next[pos];
-		} else {
-			break;
-		}
+void Trie::suffixDFS(FuzzySearch &search, const string pref, MyersPattern::Column column, uint32_t node, unsigned int worker) const {
+	const radix_node_t &chr = this->nodes[node];
+	const char *label = this->labels.data() + chr.label_offset;
+	unsigned int column_min = search.pattern.minimum(column);
+	for (uint16_t i = 0; i < chr.label_size; i++) {
+		search.pattern.advance(column, label[i]);
+		column_min = search.pattern.minimum(column);
+		if (column_min >= search.cutoff.load(memory_order_relaxed))
+			return;
 	}
 
-	if (!chr.eow)
-		tmp_word = word.substr(0, preffix.length());
-	else {
-		tmp_word = word;
-	}
-
-	dist = editDistance(preffix, tmp_word);
-	flag.lock();
-	if (dist <= (*min_dist) || chr.eow) {
-		if (chr.eow && dist <= (*min_dist)) {
-			if (dist < (*min_dist)) {
-				results->clear();
-				(*min_dist) = dist;
-			}
-			results->push_front(preffix);
-		}
-		flag.unlock();
-		for (unsigned int i = 0; i < ARR_SIZE; i++)
-			if (chr.next != nullptr
-					&& (chr.next[i].next != nullptr || chr.next[i].eow))
-				all_threads.push_front(
-						thread(&Trie::suffixDFS, word,
-								preffix + (char) arrPosToChar(i), chr.next[i],
-								min_dist, results));
-	} else
-		flag.unlock();
-
-	for (auto it = all_threads.begin(); it != all_threads.end(); it++)
-		it->join();
-}
-
-unsigned int Trie::findInitK(const std::string &word) const {
-	node_t *temp = this->root.next, *ttmp;
-	unsigned int edit_dist = 0, i = 0;
-	unsigned char pos = 0;
-
-	for (i = 0; i < word.length(); i++) {
-		pos = charToArrPos(word[i]);
-
-		if (temp != nullptr && temp[pos].next == nullptr) { //does not have current character
-			unsigned int str_len = (word.length() - i);
-			string tmp = word.substr(i, str_len);
-			if ((ttmp = this->findWordInSubtrie(tmp, temp, &str_len))
-					!= nullptr) { //suffix exists in subtrie
-				temp = ttmp;
-				i += str_len;
-				edit_dist += str_len;
-				continue;
-			} else { //suffix does not exist
-				break;
-			}
-		} else if (temp == nullptr) //reached end of trie
-			break;
-
-		temp = temp[charToArrPos(word[i])].next;
+	string preffix = pref + this->label(node);
+	if (chr.eow) {
+		unsigned int dist = search.pattern.distance(column);
+		if (dist < search.cutoff.load(memory_order_relaxed))
+			search.offer(dist, preffix);
 	}
-
-	unsigned int min = 0;
-	this->closestEOW(temp, min);
-	if ((i + min) < word.length()) //End of trie reached, but there is still words to search
-		min += (word.length() - i - 1);
-
-	return edit_dist + min;
+	if (column_min >= search.cutoff.load(memory_order_relaxed))
+		return;
+	for (uint64_t bits = chr.children, child = chr.first_child; bits != 0; bits &= bits - 1, child++)
+		this->pool.spawn(worker, [this, &search, preffix, column, child] (unsigned int worker) {
+			this->suffixDFS(search, preffix, column, (uint32_t) child, worker);
+		});
 }
 
-node_t *Trie::findWordInSubtrie(const string &word, node_t *arr,
-		unsigned int *max_depth) const {
-	unsigned int max_init = (*max_depth), cont = 1, pre_cont = 0;
-	unsigned int pos = 0;
-	queue<node_t *> q;
-	q.push(arr);
-
-	while (!q.empty() && (*max_depth) > 0) {
-		node_t * tmp = q.front();
-		q.pop();
-		cont--;
-		pos = charToArrPos(word[max_init - (*max_depth)]);
-		if (tmp[pos].next != nullptr) { //character found
-			(*max_depth) = max_init - (*max_depth); //edit distance
-			return tmp[pos].next;
-		}
-
-		for (unsigned int i = 0; i < ARR_SIZE; i++) { //insert next nodes
-			if (tmp[i].next != nullptr) {
-				q.push(tmp[i].next);
-				pre_cont++;
-			}
-		}
-		if (cont <= 0) { //Next Level
-			cont = pre_cont;
-			pre_cont = 0;
-			(*max_depth)--;
+unsigned int Trie::findInitK(const MyersPattern &pattern, string &closest) const {
+	unsigned int bound = UINT_MAX;
+	MyersPattern::Column column = pattern.start(), best_column;
+	uint32_t node = 0;
+	string prefix;
+	while (true) {
+		if (this->nodes[node].eow && pattern.distance(column) < bound) {
+			bound = pattern.distance(column);
+			closest = prefix;
 		}
-	}
-	return nullptr;
-}
-
-node_t *Trie::closestEOW(node_t *arr, unsigned int &depth) const {
-	unsigned int cont = 1, pre_cont = 0;
-	depth = 1;
-	queue<node_t *> q;
-	q.push(arr);
-	while (!q.empty() && arr != nullptr) {
-		node_t * tmp = q.front();
-		q.pop();
-		cont--;
-
-		for (unsigned int i = 0; i < ARR_SIZE; i++) { //insert next nodes
-			if (tmp[i].eow) {
-				return tmp[i].next;
-			} else if (tmp[i].next != nullptr) {
-				q.push(tmp[i].next);
-				pre_cont++;
+		uint32_t best = NO_NODE;
+		unsigned int best_min = UINT_MAX;
+		for (uint64_t bits = this->nodes[node].children, child = this->nodes[node].first_child; bits != 0; bits &= bits - 1, child++) {
+			MyersPattern::Column child_column = column;
+			for (char chr : this->label(child))
+				pattern.advance(child_column, chr);
+			unsigned int child_min = pattern.minimum(child_column);
+			if (child_min < best_min) {
+				best_min = child_min;
+				best = child;
+				best_column.bits.swap(child_column.bits);
+				best_column.depth = child_column.depth;
 			}
 		}
-
-		if (cont <= 0) { //Next Level
-			cont = pre_cont;
-			if (pre_cont != 0)
-				depth++;
-			pre_cont = 0;
-		}
+		if (best == NO_NODE || best_min >= bound)
+			return bound;
+		node = best;
+		prefix += this->label(node);
+		column = best_column;
 	}
-
-	return nullptr;
 }
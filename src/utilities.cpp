@@ -31,16 +31,6 @@ string getStreetName(){
 	return streetName;
 }
 
-unsigned int numberOfLines(const char * file_name){
-    unsigned int number_of_lines = 0;
-    FILE *in = fopen(file_name, "r");
-    int ch;
-    while (EOF != ( ch =getc(in)))
-        if ('\n' == ch)
-            ++number_of_lines;
-    return number_of_lines;
-}
-
 void printSquareArray(int ** arr, unsigned int size){
 	for(unsigned int k = 0; k < size; k++){
 		if(k == 0){
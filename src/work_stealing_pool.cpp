@@ -0,0 +1,101 @@
+#include "../headers/work_stealing_pool.h"
+
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(unsigned int n_threads) : pending(0) {
+	if (n_threads == 0)
+		n_threads = thread::hardware_concurrency();
+	if (n_threads == 0)
+		n_threads = 1;
+	for (unsigned int w = 0; w < n_threads; w++)
+		this->queues.push_back(unique_ptr<Queue>(new Queue));
+	for (unsigned int w = 1; w < n_threads; w++)
+		this->workers.push_back(thread(&WorkStealingPool::workerLoop, this, w));
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		lock_guard<mutex> guard(this->lock);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	for (thread &t : this->workers)
+		t.join();
+}
+
+void WorkStealingPool::run(const Task &root) {
+	lock_guard<mutex> turn(this->running);
+	this->spawn(0, root);
+	if (this->workers.empty()) {
+		this->work(0);
+		return;
+	}
+	{
+		lock_guard<mutex> guard(this->lock);
+		this->busy = this->workers.size();
+		this->generation++;
+	}
+	this->wake.notify_all();
+	this->work(0);
+
+	unique_lock<mutex> guard(this->lock);
+	this->done.wait(guard, [this] { return this->busy == 0; });
+}
+
+void WorkStealingPool::spawn(unsigned int worker, Task task) {
+	this->pending.fetch_add(1);
+	Queue &queue = *this->queues[worker];
+	lock_guard<mutex> guard(queue.lock);
+	queue.tasks.push_back(move(task));
+}
+
+bool WorkStealingPool::pop(unsigned int worker, Task &task) {
+	Queue &queue = *this->queues[worker];
+	lock_guard<mutex> guard(queue.lock);
+	if (queue.tasks.empty())
+		return false;
+	task = move(queue.tasks.front());
+	queue.tasks.pop_front();
+	return true;
+}
+
+bool WorkStealingPool::steal(unsigned int worker, Task &task) {
+	for (unsigned int i = 1; i < this->queues.size(); i++) {
+		Queue &queue = *this->queues[(worker + i) % this->queues.size()];
+		lock_guard<mutex> guard(queue.lock);
+		if (!queue.tasks.empty()) {
+			task = move(queue.tasks.back());
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingPool::work(unsigned int worker) {
+	Task task;
+	while (this->pending.load() != 0) {
+		if (this->pop(worker, task) || this->steal(worker, task)) {
+			task(worker);
+			task = nullptr;
+			this->pending.fetch_sub(1); //after the task, so its children are counted before it is done
+		} else
+			this_thread::yield();
+	}
+}
+
+void WorkStealingPool::workerLoop(unsigned int worker) {
+	unsigned long int seen = 0;
+	unique_lock<mutex> guard(this->lock);
+	while (true) {
+		this->wake.wait(guard, [this, seen] { return this->stopping || this->generation != seen; });
+		if (this->stopping)
+			return;
+		seen = this->generation;
+		guard.unlock();
+		this->work(worker);
+		guard.lock();
+		if (--this->busy == 0)
+			this->done.notify_one();
+	}
+}
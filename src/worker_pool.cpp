@@ -0,0 +1,64 @@
+#include "../headers/worker_pool.h"
+
+using namespace std;
+
+WorkerPool::WorkerPool(unsigned int n_threads) : next(0) {
+	if (n_threads == 0)
+		n_threads = thread::hardware_concurrency();
+	for (unsigned int w = 1; w < n_threads; w++)
+		this->workers.push_back(thread(&WorkerPool::workerLoop, this, w));
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		lock_guard<mutex> guard(this->lock);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	for (thread &t : this->workers)
+		t.join();
+}
+
+void WorkerPool::parallelFor(unsigned int count, const function<void(unsigned int, unsigned int)> &body) {
+	if (this->workers.empty() || count <= 1) {
+		for (unsigned int i = 0; i < count; i++)
+			body(i, 0);
+		return;
+	}
+	{
+		lock_guard<mutex> guard(this->lock);
+		this->job = &body;
+		this->job_size = count;
+		this->next = 0;
+		this->busy = this->workers.size();
+		this->generation++;
+	}
+	this->wake.notify_all();
+	this->run(0);
+
+	unique_lock<mutex> guard(this->lock);
+	this->done.wait(guard, [this] { return this->busy == 0; });
+	this->job = nullptr;
+}
+
+void WorkerPool::run(unsigned int worker) {
+	unsigned int i;
+	while ((i = this->next.fetch_add(1)) < this->job_size)
+		(*this->job)(i, worker);
+}
+
+void WorkerPool::workerLoop(unsigned int worker) {
+	unsigned long int seen = 0;
+	unique_lock<mutex> guard(this->lock);
+	while (true) {
+		this->wake.wait(guard, [this, seen] { return this->stopping || this->generation != seen; });
+		if (this->stopping)
+			return;
+		seen = this->generation;
+		guard.unlock();
+		this->run(worker);
+		guard.lock();
+		if (--this->busy == 0)
+			this->done.notify_one();
+	}
+}